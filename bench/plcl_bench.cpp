@@ -0,0 +1,335 @@
+// SPDX-License-Identifier: Apache-2.0
+
+// Microbenchmarks for the lexer, the parsers, the serializer and the validator.
+//
+// The inputs are generated, so runs are comparable between machines and versions without any data files. Every
+// benchmark is timed one operation at a time until it has run for at least `--min-time` seconds, and the results are
+// written as JSON, one object per benchmark:
+//
+//   bytes, tokens            The size of the input (of the output, for serializing) and the number of tokens in it.
+//   iterations               The number of timed operations.
+//   ns_min, ns_median, ...   The duration of one operation.
+//   mb_per_s, tokens_per_s   Throughput, from the median duration.
+//   allocations, ...         Calls to operator new and the bytes they asked for, per operation.
+//
+// Run with --help for the options.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <libPLCL.hpp>
+
+#ifndef PLCL_BENCH_VERSION
+#define PLCL_BENCH_VERSION "unknown"
+#endif
+
+namespace {
+    std::atomic<uint64_t> allocationCount = 0;
+    std::atomic<uint64_t> allocatedBytes = 0;
+
+    void* allocate(size_t size, size_t alignment) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0) {
+            size = 1;
+        }
+        void* memory = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            memory = std::malloc(size);
+        } else {
+            memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+}
+
+// Counts every heap allocation of the process. The array and nothrow forms forward to these.
+void* operator new(size_t size) {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+    constexpr std::string_view usage = "Usage: plcl_bench [--elements N] [--kinds N] [--min-time SECONDS] [--filter TEXT] [--output PATH]";
+
+    struct Options {
+        bool help = false;
+        size_t elements = 20000;
+        size_t kinds = 200;
+        double minTime = 0.5;
+        std::string filter;
+        std::string output;
+    };
+
+    struct Result {
+        std::string name;
+        size_t bytes;
+        size_t tokens;
+        size_t iterations;
+        double nsMin;
+        double nsMedian;
+        double nsMean;
+        double allocations;
+        double allocatedBytes;
+    };
+
+    Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            std::string_view option = argv[i];
+            if (option == "--help" || option == "-h") {
+                options.help = true;
+                return options;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Expected a value after {}", option));
+            }
+            std::string value = argv[++i];
+            if (option == "--elements") {
+                options.elements = std::stoul(value);
+            } else if (option == "--kinds") {
+                options.kinds = std::max<size_t>(1, std::stoul(value));
+            } else if (option == "--min-time") {
+                options.minTime = std::stod(value);
+            } else if (option == "--filter") {
+                options.filter = value;
+            } else if (option == "--output") {
+                options.output = value;
+            } else {
+                throw std::runtime_error(std::format("Unknown option {}", option));
+            }
+        }
+        return options;
+    }
+
+    // `kinds` element types, each with the four attribute types and a list of nested elements.
+    std::string generateTemplate(size_t kinds) {
+        std::string result = "TemplateName Bench\n\n";
+        for (size_t kind = 0; kind < kinds; kind++) {
+            std::format_to(std::back_inserter(result),
+                           "TemplateElement Kind{0}\n"
+                           "    int identifier required\n"
+                           "    string name\n"
+                           "    bool enabled default false\n"
+                           "    float weight default 1.0\n"
+                           "    TemplateList Tags{0}\n"
+                           "        TemplateListElement 0\n"
+                           "            TemplateElement Tag{0}\n"
+                           "                string label required\n"
+                           "            endTemplateElement\n"
+                           "        endTemplateListElement\n"
+                           "    endTemplateList\n"
+                           "endTemplateElement\n\n",
+                           kind);
+        }
+        return result;
+    }
+
+    // A configuration that is valid against `generateTemplate(kinds)`.
+    std::string generateConfig(size_t elements, size_t kinds) {
+        std::string result = "ConfigName Bench\n\n";
+        for (size_t i = 0; i < elements; i++) {
+            std::format_to(std::back_inserter(result),
+                           "; Element {0}\n"
+                           "ConfigElement Kind{1}\n"
+                           "    identifier = {0}\n"
+                           "    name = \"element number {0}\"\n"
+                           "    enabled = {2}\n"
+                           "    weight = {3}.25\n"
+                           "    ConfigList Tags{1}\n"
+                           "        ConfigListElement 0\n"
+                           "            ConfigElement Tag{1}\n"
+                           "                label = \"first\"\n"
+                           "            endConfigElement\n"
+                           "        endConfigListElement\n"
+                           "        ConfigListElement 1\n"
+                           "            ConfigElement Tag{1}\n"
+                           "                label = \"second\"\n"
+                           "            endConfigElement\n"
+                           "        endConfigListElement\n"
+                           "    endConfigList\n"
+                           "endConfigElement\n\n",
+                           i, i % kinds, i % 2 == 0 ? "true" : "false", i % 100);
+        }
+        return result;
+    }
+
+    // Identifiers and keywords only, for the keyword recognition of the lexer.
+    std::string generateIdentifiers(size_t count) {
+        static constexpr std::string_view words[] = {"a", "hi", "attribute", "value", "ConfigElement", "endConfigElement", "threshold_1", "TemplateListElement"};
+        std::string result;
+        for (size_t i = 0; i < count; i++) {
+            result += words[i % std::size(words)];
+            result += i % 16 == 15 ? '\n' : ' ';
+        }
+        return result;
+    }
+
+    size_t countTokens(std::string_view input) {
+        PLCL::Lexer lexer(input);
+        return lexer.lex().size() - 1;
+    }
+
+    class Runner {
+    public:
+        explicit Runner(const Options& options) : options(options) {}
+
+        // Times `operation`, which returns something to keep alive until the clock has stopped, so destroying the
+        // result isn't measured.
+        template <typename Operation>
+        void run(std::string_view name, size_t bytes, size_t tokens, Operation&& operation) {
+            if (!this->options.filter.empty() && name.find(this->options.filter) == std::string_view::npos) {
+                return;
+            }
+            (void) operation();
+
+            using Clock = std::chrono::steady_clock;
+            std::vector<double> samples;
+            uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+            Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(this->options.minTime));
+            while (samples.size() < minimumIterations || Clock::now() < deadline) {
+                Clock::time_point start = Clock::now();
+                [[maybe_unused]] auto result = operation();
+                Clock::time_point end = Clock::now();
+                samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            }
+            uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            uint64_t allocated = allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+            // The samples vector itself grows while measuring, which is a handful of allocations in total.
+            double mean = 0;
+            for (double sample : samples) {
+                mean += sample;
+            }
+            mean /= static_cast<double>(samples.size());
+            std::ranges::sort(samples);
+            auto iterations = static_cast<double>(samples.size());
+            this->results.push_back({std::string(name), bytes, tokens, samples.size(), samples.front(), samples[samples.size() / 2], mean,
+                                     static_cast<double>(allocations) / iterations, static_cast<double>(allocated) / iterations});
+            std::cerr << std::format("{:<28} {:>12.0f} ns {:>10.1f} MB/s {:>12.0f} allocations\n", name, samples[samples.size() / 2],
+                                     static_cast<double>(bytes) / samples[samples.size() / 2] * 1e3, static_cast<double>(allocations) / iterations);
+        }
+
+        [[nodiscard]] std::string json() const {
+            std::string result = std::format("{{\n  \"library\": \"libPLCL\",\n  \"version\": \"{}\",\n  \"threads\": {},\n  \"elements\": {},\n  \"kinds\": {},\n  \"benchmarks\": [",
+                                             PLCL_BENCH_VERSION, std::thread::hardware_concurrency(), this->options.elements, this->options.kinds);
+            for (size_t i = 0; i < this->results.size(); i++) {
+                const Result& r = this->results[i];
+                double seconds = r.nsMedian / 1e9;
+                std::format_to(std::back_inserter(result),
+                               "{}\n    {{\"name\": \"{}\", \"bytes\": {}, \"tokens\": {}, \"iterations\": {}, \"ns_min\": {:.0f}, \"ns_median\": {:.0f}, \"ns_mean\": {:.0f}, "
+                               "\"mb_per_s\": {:.3f}, \"tokens_per_s\": {:.0f}, \"allocations\": {:.1f}, \"allocated_bytes\": {:.0f}}}",
+                               i == 0 ? "" : ",", r.name, r.bytes, r.tokens, r.iterations, r.nsMin, r.nsMedian, r.nsMean, static_cast<double>(r.bytes) / 1e6 / seconds,
+                               static_cast<double>(r.tokens) / seconds, r.allocations, r.allocatedBytes);
+            }
+            result += "\n  ]\n}\n";
+            return result;
+        }
+
+    private:
+        static constexpr size_t minimumIterations = 5;
+
+        const Options& options;
+        std::vector<Result> results;
+    };
+}
+
+int main(int argc, char** argv) {
+    try {
+        Options options = parseOptions(argc, argv);
+        if (options.help) {
+            std::cout << usage << '\n';
+            return 0;
+        }
+        std::string templateText = generateTemplate(options.kinds);
+        std::string configText = generateConfig(options.elements, options.kinds);
+        std::string identifiers = generateIdentifiers(options.elements * 20);
+        size_t templateTokens = countTokens(templateText);
+        size_t configTokens = countTokens(configText);
+
+        Runner runner(options);
+
+        runner.run("lex/config", configText.size(), configTokens, [&] {
+            PLCL::Lexer lexer(configText);
+            return lexer.lex();
+        });
+        runner.run("lex/identifiers", identifiers.size(), countTokens(identifiers), [&] {
+            PLCL::Lexer lexer(identifiers);
+            return lexer.lex();
+        });
+
+        runner.run("config/fromString", configText.size(), configTokens, [&] {
+            return PLCL::Config::ConfigRoot::fromString(configText);
+        });
+        runner.run("template/fromString", templateText.size(), templateTokens, [&] {
+            return PLCL::Template::TemplateRoot::fromString(templateText);
+        });
+
+        PLCL::Config::ConfigRoot config = PLCL::Config::ConfigRoot::fromString(configText);
+        PLCL::Template::TemplateRoot configTemplate = PLCL::Template::TemplateRoot::fromString(templateText);
+        std::string configOutput = config.toString(4);
+        std::string templateOutput = configTemplate.toString(4);
+
+        runner.run("config/toString", configOutput.size(), countTokens(configOutput), [&] {
+            return config.toString(4);
+        });
+        runner.run("template/toString", templateOutput.size(), countTokens(templateOutput), [&] {
+            return configTemplate.toString(4);
+        });
+
+        runner.run("config/verify", configText.size(), configTokens, [&] {
+            config.verify(configTemplate, true);
+            return true;
+        });
+
+        if (options.output.empty()) {
+            std::cout << runner.json();
+        } else {
+            std::ofstream file(options.output);
+            if (!file) {
+                throw std::runtime_error(std::format("Couldn't open {}", options.output));
+            }
+            file << runner.json();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n' << usage << '\n';
+        return 1;
+    }
+    return 0;
+}
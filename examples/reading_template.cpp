@@ -39,18 +39,18 @@ endTemplateList
 
 void printElement(PLCL::Template::TemplateElement& element, size_t indent);
 
-std::string valueTypeToString(PLCL::Generic::ValueType& value) {
-    if (std::holds_alternative<std::string>(value)) {
-        return std::get<std::string>(value);
+std::string valueTypeToString(PLCL::Generic::Value& value) {
+    if (PLCL::Generic::holds_alternative<std::string_view>(value)) {
+        return std::string(PLCL::Generic::get<std::string_view>(value));
     }
-    if (std::holds_alternative<int64_t>(value)) {
-        return std::to_string(std::get<int64_t>(value));
+    if (PLCL::Generic::holds_alternative<int64_t>(value)) {
+        return std::to_string(PLCL::Generic::get<int64_t>(value));
     }
-    if (std::holds_alternative<PLCL::Generic::float64_t>(value)) {
-        return std::to_string(std::get<PLCL::Generic::float64_t>(value));
+    if (PLCL::Generic::holds_alternative<PLCL::Generic::float64_t>(value)) {
+        return std::to_string(PLCL::Generic::get<PLCL::Generic::float64_t>(value));
     }
-    if (std::holds_alternative<bool>(value)) {
-        return std::get<bool>(value) ? "true" : "false";
+    if (PLCL::Generic::holds_alternative<bool>(value)) {
+        return PLCL::Generic::get<bool>(value) ? "true" : "false";
     }
     return "Unreachable";
 }
@@ -9,7 +9,22 @@
 /// @brief The namespace for the entire library.
 
 #pragma once
+#include "libPLCL/Binary.hpp"
 #include "libPLCL/Lexer.hpp"
 #include "libPLCL/Template.hpp"
 #include "libPLCL/Generic.hpp"
 #include "libPLCL/Config.hpp"
+#include "libPLCL/ConfigHandler.hpp"
+#include "libPLCL/ConfigDocument.hpp"
+#include "libPLCL/ConfigHandle.hpp"
+#include "libPLCL/ConfigIndex.hpp"
+#include "libPLCL/ConfigPath.hpp"
+#include "libPLCL/ImportGraph.hpp"
+#include "libPLCL/FlatConfig.hpp"
+#include "libPLCL/ParseCache.hpp"
+#include "libPLCL/Serializer.hpp"
+#include "libPLCL/SourceFile.hpp"
+#include "libPLCL/Symbol.hpp"
+#include "libPLCL/TemplateRegistry.hpp"
+#include "libPLCL/Validator.hpp"
+#include "libPLCL/Value.hpp"
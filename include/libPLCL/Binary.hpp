@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief The building blocks of the binary format of configurations and templates.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @namespace PLCL::Binary
+/// @brief Encoding and decoding parsed trees without going through text.
+/// @details A binary file starts with a header: the magic bytes `PLCB`, the format version as a varint, and a byte
+/// for the kind of tree, `C` for configurations and `T` for templates. Then comes the string table, a varint count
+/// followed by every string as a varint length and its bytes, each distinct string only once. The tree follows,
+/// depth-first, with strings as varint indices into the table, counts, ids and integers as varints (zigzag for signed
+/// ones), and floats as the 8 little-endian bytes of their IEEE 754 representation. A configuration ends with its
+/// `listPositions`, as a count and varints.
+///
+/// @var PLCL::Binary::version
+/// @brief The version of the format, bumped whenever the encoding of anything changes.
+///
+/// @class PLCL::Binary::Writer
+/// @brief Encodes a tree, interning its strings along the way.
+///
+/// @fn PLCL::Binary::Writer::Writer(char kind)
+/// @brief Starts encoding a tree of the given kind.
+///
+/// @fn void PLCL::Binary::Writer::string(std::string_view value)
+/// @brief Writes a reference to a string, adding it to the table if it isn't there yet.
+/// @details The table keeps a view of the string, it must outlive the writer.
+///
+/// @fn std::string PLCL::Binary::Writer::finish()
+/// @brief Returns the whole encoding, header and string table included.
+///
+/// @class PLCL::Binary::Reader
+/// @brief Decodes a tree, checking every read against the end of the input.
+///
+/// @fn PLCL::Binary::Reader::Reader(std::string_view data, char kind)
+/// @brief Checks the header and reads the string table.
+/// @param data The encoding, the strings returned by `string()` are views into it.
+/// @param kind The kind of tree expected.
+/// @throws std::runtime_error If the header is wrong or the string table is truncated.
+///
+/// @fn size_t PLCL::Binary::Reader::count()
+/// @brief Reads the number of items that follow.
+/// @details Every item takes at least one byte, so counts larger than what's left are rejected before anything is
+/// allocated for them.
+///
+/// @fn void PLCL::Binary::Reader::finish()
+/// @brief Checks that the whole input was read.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Generic.hpp"
+#include "Value.hpp"
+
+namespace PLCL::Binary {
+    static constexpr uint64_t version = 2;
+
+    class Writer {
+    public:
+        explicit Writer(char kind) : kind(kind) {}
+
+        void byte(uint8_t value);
+        void varint(uint64_t value);
+        void integer(int64_t value);
+        void float64(Generic::float64_t value);
+        void string(std::string_view value);
+        void value(const Generic::Value& value);
+        [[nodiscard]] std::string finish() const;
+
+    private:
+        char kind;
+        std::string body;
+        std::vector<std::string_view> strings;
+        std::unordered_map<std::string_view, uint64_t> ids;
+    };
+
+    class Reader {
+    public:
+        Reader(std::string_view data, char kind);
+
+        uint8_t byte();
+        uint64_t varint();
+        int64_t integer();
+        Generic::float64_t float64();
+        std::string_view string();
+        Generic::Value value(Generic::Allocator alloc);
+        size_t count();
+        void finish() const;
+
+    private:
+        std::string_view data;
+        size_t index = 0;
+        std::vector<std::string_view> strings;
+    };
+}
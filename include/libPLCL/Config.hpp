@@ -11,11 +11,17 @@
 /// @brief A struct that represents the root of a configuration tree.
 /// @details It's used to store the parsed configuration.
 ///
+/// @var PLCL::Config::ConfigRoot::arena
+/// @brief The arena every node of a parsed tree, and every string those nodes own, is allocated from.
+/// @details It's shared between copies of the root, the whole tree is freed at once when the last copy is destroyed.
+/// It's null for trees built by hand.
+///
 /// @var PLCL::Config::ConfigRoot::name
 /// @brief The name of the configuration.
 ///
 /// @var PLCL::Config::ConfigRoot::imports
-/// @brief The list of imported templates.
+/// @brief The list of imports, as written.
+/// @details They're paths of other configurations, `ImportGraph` loads them.
 ///
 /// @var PLCL::Config::ConfigRoot::elements
 /// @brief The list of elements in the top level of the configuration.
@@ -23,34 +29,74 @@
 /// @var PLCL::Config::ConfigRoot::lists
 /// @brief The list of lists in the top level of the configuration.
 ///
+/// @var PLCL::Config::ConfigRoot::listPositions
+/// @brief For each list in `lists`, the number of elements of `elements` written before it.
+/// @details It keeps the source order of the top level, which `elements` and `lists` alone lose, so problems can be
+/// reported in that order. It's filled in by parsing and kept by the binary format. If its size doesn't match
+/// `lists`, e.g. for trees built by hand, the order isn't known and the lists count as written after every element.
+///
 /// @fn PLCL::Config::ConfigRoot::ConfigRoot()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Config::ConfigRoot::ConfigRoot(std::vector<Lexer::Token>& tokens)
-/// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
+/// @fn PLCL::Config::ConfigRoot::ConfigRoot(Lexer::TokenStream& tokens)
+/// @brief Constructor that parses tokens from the lexer into a new arena.
+/// @param tokens The stream of tokens to parse.
+///
+/// @fn PLCL::Config::ConfigRoot::ConfigRoot(Lexer::TokenStream& tokens, std::shared_ptr<Generic::Arena> arena)
+/// @brief Constructor that parses tokens from the lexer into the given arena.
+/// @param tokens The stream of tokens to parse.
+/// @param arena The arena to allocate the tree from.
 ///
-/// @fn PLCL::Config::ConfigRoot::ConfigRoot(std::string name, std::vector<std::string> imports, std::vector<ConfigElement*> elements, std::vector<ConfigList*> lists)
+/// @fn PLCL::Config::ConfigRoot::ConfigRoot(std::pmr::string name, std::pmr::vector<std::pmr::string> imports, std::pmr::vector<ConfigElement*> elements, std::pmr::vector<ConfigList*> lists)
 /// @brief Constructor that initializes all fields.
 /// @param name The name of the configuration.
 /// @param imports The list of imported templates.
 /// @param elements The list of elements in the top level of the configuration.
 /// @param lists The list of lists in the top level of the configuration.
 ///
-/// @fn PLCL::Config::ConfigRoot PLCL::Config::ConfigRoot::fromString(const std::string& input)
+/// @fn PLCL::Config::ConfigRoot PLCL::Config::ConfigRoot::fromString(std::string_view input)
 /// @brief Parses a configuration from a string.
 /// @param input The string to parse.
 /// @return The parsed configuration.
 ///
-/// @fn void PLCL::Config::ConfigRoot::verify(Template::TemplateRoot& configTemplate, bool strict)
+/// @fn PLCL::Config::ConfigRoot PLCL::Config::ConfigRoot::fromFile(const std::filesystem::path& path)
+/// @brief Parses a configuration from a file.
+/// @details The file is lexed in place, see `SourceFile`. It isn't needed once this returns.
+/// @param path The path of the file to parse.
+/// @return The parsed configuration.
+///
+/// @fn PLCL::Config::ConfigRoot PLCL::Config::ConfigRoot::fromBinary(std::string_view data)
+/// @brief Decodes a configuration produced by `toBinary()`.
+/// @details Nothing is lexed or parsed, the tree is rebuilt in a single pass with its strings copied straight from
+/// the string table. The data isn't needed once this returns.
+/// @param data The encoded configuration.
+/// @return The decoded configuration.
+/// @throws std::runtime_error If the data isn't a configuration in the current binary format.
+///
+/// @fn PLCL::Config::ConfigRoot PLCL::Config::ConfigRoot::fromBinaryFile(const std::filesystem::path& path)
+/// @brief Decodes a configuration from a file written with the result of `toBinary()`.
+/// @details Large files are mapped rather than read, see `SourceFile`.
+/// @param path The path of the file.
+/// @return The decoded configuration.
+///
+/// @fn std::string PLCL::Config::ConfigRoot::toBinary() const
+/// @brief Encodes the configuration in the binary format described in `Binary.hpp`.
+/// @return The encoded configuration.
+///
+/// @fn void PLCL::Config::ConfigRoot::verify(Template::TemplateRoot& configTemplate, bool strict, bool parallel)
 /// @brief Verifies if the configuration is valid against a template.
 /// @param configTemplate The template to verify against.
-/// @param strict Whether to strictly verify the configuration.
-/// @attention This function is not implemented yet.
+/// @param strict Whether to report elements, lists and attributes that aren't in the template.
+/// @param parallel Whether to check independent parts of the configuration on several threads.
+/// @throws std::runtime_error Listing every problem found, if there are any.
+/// @details This compiles the template every time, use a `Validator` directly to check several configurations
+/// against the same template.
 ///
-/// @fn std::string PLCL::Config::ConfigRoot::toString(size_t indent)
+/// @fn std::string PLCL::Config::ConfigRoot::toString(size_t indent, bool parallel)
 /// @brief Converts the configuration to a string.
 /// @param indent The number of spaces to indent the configuration's contents.
+/// @param parallel Whether to serialize independent parts of the configuration on several threads, the result is the
+/// same either way.
 /// @return The configuration as a string.
 ///
 /// @struct PLCL::Config::ConfigList
@@ -58,7 +104,7 @@
 /// @details It's used to store a list of elements in the configuration.
 ///
 /// @var PLCL::Config::ConfigList::type
-/// @brief The type (name) of the list.
+/// @brief The type (name) of the list, interned.
 ///
 /// @var PLCL::Config::ConfigList::elements
 /// @brief The list of elements in the list.
@@ -66,13 +112,7 @@
 /// @fn PLCL::Config::ConfigList::ConfigList()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Config::ConfigList::ConfigList(std::vector<Lexer::Token>& tokens, size_t& index)
-/// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the token to start parsing from.
-/// @attention This function is for internal use only.
-///
-/// @fn PLCL::Config::ConfigList::ConfigList(std::string type, std::vector<ConfigListElement*> elements)
+/// @fn PLCL::Config::ConfigList::ConfigList(Symbol type, std::pmr::vector<ConfigListElement*> elements)
 /// @brief Constructor that initializes all fields.
 /// @param type The type (name) of the list.
 /// @param elements The list of elements in the list.
@@ -96,12 +136,6 @@
 /// @fn PLCL::Config::ConfigListElement::ConfigListElement()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Config::ConfigListElement::ConfigListElement(std::vector<Lexer::Token>& tokens, size_t& index)
-/// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the token to start parsing from.
-/// @attention This function is for internal use only.
-///
 /// @fn PLCL::Config::ConfigListElement::ConfigListElement(size_t id, ConfigElement* element)
 /// @brief Constructor that initializes all fields.
 /// @param id The id of the element in the list.
@@ -117,7 +151,7 @@
 /// @brief A struct that represents an element in the configuration tree.
 ///
 /// @var PLCL::Config::ConfigElement::type
-/// @brief The type (name) of the element.
+/// @brief The type (name) of the element, interned.
 ///
 /// @var PLCL::Config::ConfigElement::attributes
 /// @brief The list of attributes of the element.
@@ -128,13 +162,7 @@
 /// @fn PLCL::Config::ConfigElement::ConfigElement()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Config::ConfigElement::ConfigElement(std::vector<Lexer::Token>& tokens, size_t& index)
-/// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the token to start parsing from.
-/// @attention This function is for internal use only.
-///
-/// @fn PLCL::Config::ConfigElement::ConfigElement(std::string type, std::vector<ConfigElementAttribute*> attributes, std::vector<ConfigList*> lists)
+/// @fn PLCL::Config::ConfigElement::ConfigElement(Symbol type, std::pmr::vector<ConfigElementAttribute*> attributes, std::pmr::vector<ConfigList*> lists)
 /// @brief Constructor that initializes all fields.
 /// @param type The type (name) of the element.
 /// @param attributes The list of attributes of the element.
@@ -150,7 +178,7 @@
 /// @brief A struct that represents an attribute of an element.
 ///
 /// @var PLCL::Config::ConfigElementAttribute::name
-/// @brief The name of the attribute.
+/// @brief The name of the attribute, interned.
 ///
 /// @var PLCL::Config::ConfigElementAttribute::value
 /// @brief The value of the attribute.
@@ -158,13 +186,7 @@
 /// @fn PLCL::Config::ConfigElementAttribute::ConfigElementAttribute()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Config::ConfigElementAttribute::ConfigElementAttribute(std::vector<Lexer::Token>& tokens, size_t& index)
-/// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the token to start parsing from.
-/// @attention This function is for internal use only.
-///
-/// @fn PLCL::Config::ConfigElementAttribute::ConfigElementAttribute(std::string name, Generic::ValueType value)
+/// @fn PLCL::Config::ConfigElementAttribute::ConfigElementAttribute(Symbol name, Generic::Value value)
 /// @brief Constructor that initializes all fields.
 /// @param name The name of the attribute.
 /// @param value The value of the attribute.
@@ -176,10 +198,16 @@
 
 
 #pragma once
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "Generic.hpp"
 #include "Lexer.hpp"
+#include "Symbol.hpp"
 #include "Template.hpp"
+#include "Value.hpp"
 
 namespace PLCL::Config {
     struct ConfigRoot;
@@ -189,29 +217,35 @@ namespace PLCL::Config {
     struct ConfigElementAttribute;
 
     struct ConfigRoot {
-        std::string name;
-        std::vector<std::string> imports;
-        std::vector<ConfigElement*> elements;
-        std::vector<ConfigList*> lists;
+        std::shared_ptr<Generic::Arena> arena;
+        std::pmr::string name;
+        std::pmr::vector<std::pmr::string> imports;
+        std::pmr::vector<ConfigElement*> elements;
+        std::pmr::vector<ConfigList*> lists;
+        std::pmr::vector<size_t> listPositions;
 
         ConfigRoot() = default;
-        explicit ConfigRoot(std::vector<Lexer::Token>& tokens);
-        [[maybe_unused]] ConfigRoot(std::string name, std::vector<std::string> imports, std::vector<ConfigElement*> elements, std::vector<ConfigList*> lists)
+        explicit ConfigRoot(Lexer::TokenStream& tokens);
+        ConfigRoot(Lexer::TokenStream& tokens, std::shared_ptr<Generic::Arena> arena);
+        [[maybe_unused]] ConfigRoot(std::pmr::string name, std::pmr::vector<std::pmr::string> imports, std::pmr::vector<ConfigElement*> elements, std::pmr::vector<ConfigList*> lists)
             : name(std::move(name)), imports(std::move(imports)), elements(std::move(elements)), lists(std::move(lists)) {};
 
-        [[maybe_unused]] static ConfigRoot fromString(const std::string& input);
-        [[maybe_unused]] void verify(Template::TemplateRoot& configTemplate, bool strict);
-        [[maybe_unused]] std::string toString(size_t indent);
+        [[maybe_unused]] static ConfigRoot fromString(std::string_view input);
+        [[maybe_unused]] static ConfigRoot fromFile(const std::filesystem::path& path);
+        [[maybe_unused]] static ConfigRoot fromBinary(std::string_view data);
+        [[maybe_unused]] static ConfigRoot fromBinaryFile(const std::filesystem::path& path);
+        [[maybe_unused]] std::string toBinary() const;
+        [[maybe_unused]] void verify(Template::TemplateRoot& configTemplate, bool strict, bool parallel = false);
+        [[maybe_unused]] std::string toString(size_t indent, bool parallel = false);
     };
 
     struct ConfigList {
-        std::string type;
-        std::vector<ConfigListElement*> elements;
+        Symbol type;
+        std::pmr::vector<ConfigListElement*> elements;
 
         ConfigList() = default;
-        ConfigList(std::vector<Lexer::Token>& tokens, size_t& index);
-        ConfigList(std::string type, std::vector<ConfigListElement*> elements)
-            : type(std::move(type)), elements(std::move(elements)) {};
+        ConfigList(Symbol type, std::pmr::vector<ConfigListElement*> elements)
+            : type(type), elements(std::move(elements)) {};
 
         [[maybe_unused]] std::string toString(size_t indent, size_t indentStart);
     };
@@ -221,7 +255,6 @@ namespace PLCL::Config {
         ConfigElement* element = nullptr;
 
         ConfigListElement() = default;
-        ConfigListElement(std::vector<Lexer::Token>& tokens, size_t& index);
         ConfigListElement(size_t id, ConfigElement* element)
             : id(id), element(element) {};
 
@@ -229,26 +262,24 @@ namespace PLCL::Config {
     };
 
     struct ConfigElement {
-        std::string type;
-        std::vector<ConfigElementAttribute*> attributes;
-        std::vector<ConfigList*> lists;
+        Symbol type;
+        std::pmr::vector<ConfigElementAttribute*> attributes;
+        std::pmr::vector<ConfigList*> lists;
 
         ConfigElement() = default;
-        ConfigElement(std::vector<Lexer::Token>& tokens, size_t& index);
-        ConfigElement(std::string type, std::vector<ConfigElementAttribute*> attributes, std::vector<ConfigList*> lists)
-            : type(std::move(type)), attributes(std::move(attributes)), lists(std::move(lists)) {};
+        ConfigElement(Symbol type, std::pmr::vector<ConfigElementAttribute*> attributes, std::pmr::vector<ConfigList*> lists)
+            : type(type), attributes(std::move(attributes)), lists(std::move(lists)) {};
 
         [[maybe_unused]] std::string toString(size_t indent, size_t indentStart);
     };
 
     struct ConfigElementAttribute {
-        std::string name;
-        Generic::ValueType value;
+        Symbol name;
+        Generic::Value value;
 
         ConfigElementAttribute() = default;
-        ConfigElementAttribute(std::vector<Lexer::Token>& tokens, size_t& index);
-        ConfigElementAttribute(std::string name, Generic::ValueType value)
-            : name(std::move(name)), value(std::move(value)) {};
+        ConfigElementAttribute(Symbol name, Generic::Value value)
+            : name(name), value(value) {};
 
         [[maybe_unused]] std::string toString(size_t indent);
     };
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Keeping a configuration tree in sync with a source that's being edited.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::ConfigDocument
+/// @brief The source of a configuration together with its tree, updated incrementally as the source is edited.
+/// @details Alongside the tree, the document keeps the byte range every element, list and list element came from.
+/// An edit is mapped to the smallest run of sibling nodes that covers it, only those bytes are lexed and parsed
+/// again, and the new nodes are spliced into the existing tree in place of the old ones. Every other node is left
+/// untouched, so pointers to them stay valid.
+///
+/// When the edit touches the name or the imports of the configuration, or the new text doesn't form a whole run of
+/// nodes where the old ones were, the document is parsed from scratch instead. It's also parsed from scratch once
+/// the nodes replaced since the last full parse add up to the size of the source, to free them.
+///
+/// @fn PLCL::Config::ConfigDocument::ConfigDocument(std::string source)
+/// @brief Parses a configuration.
+/// @param source The text of the configuration.
+/// @throws std::runtime_error If the configuration can't be parsed.
+///
+/// @fn void PLCL::Config::ConfigDocument::edit(size_t begin, size_t end, std::string_view replacement)
+/// @brief Replaces a range of the source and updates the tree to match.
+/// @param begin The offset of the first byte to replace.
+/// @param end The offset one past the last byte to replace, `begin` to only insert.
+/// @param replacement The text to put in place of the range.
+/// @throws std::runtime_error If the range is outside the source, or the edited source can't be parsed. In the
+/// latter case the source is still edited, `root()` keeps returning the last tree that could be parsed, and the next
+/// edit parses the document from scratch.
+///
+/// @fn const std::string& PLCL::Config::ConfigDocument::source() const
+/// @brief Returns the current text of the configuration.
+///
+/// @fn const PLCL::Config::ConfigRoot& PLCL::Config::ConfigDocument::root() const
+/// @brief Returns the tree of the configuration.
+
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Config.hpp"
+#include "Lexer.hpp"
+
+namespace PLCL::Config {
+    class ConfigDocument {
+    public:
+        explicit ConfigDocument(std::string source);
+
+        void edit(size_t begin, size_t end, std::string_view replacement);
+
+        [[nodiscard]] const std::string& source() const {
+            return this->text;
+        }
+
+        [[nodiscard]] const ConfigRoot& root() const {
+            return *this->tree;
+        }
+
+    private:
+        enum class Kind {
+            Root,
+            Element,
+            List,
+            ListElement,
+        };
+
+        // Where a node came from. `begin` is relative to the parent's, so an edit only shifts the siblings after it on
+        // each level, and `end` is relative to `begin`. A span ends where the token after the node starts, so the
+        // children of a list tile it without gaps.
+        struct Span {
+            Kind kind;
+            size_t begin;
+            size_t end;
+            void* node;
+            std::vector<Span> children;
+        };
+
+        // An edit in the coordinates of the source before it was applied.
+        struct Change {
+            size_t begin;
+            size_t end;
+            size_t size;
+
+            // Moves an offset that's at or after the end of the edit to where it is after the edit.
+            [[nodiscard]] size_t moved(size_t offset) const {
+                return offset - (this->end - this->begin) + this->size;
+            }
+        };
+
+        std::string text;
+        std::optional<ConfigRoot> tree;
+        Span spans = {Kind::Root, 0, 0, nullptr, {}};
+        bool stale = false;
+        size_t garbage = 0;
+
+        void parseAll();
+        bool reparse(Span& container, size_t base, const Change& change);
+        bool replace(Span& container, size_t base, size_t first, size_t last, const Change& change);
+
+        static std::vector<Span> scan(const std::vector<Lexer::Token>& tokens, size_t& index, size_t base);
+        static void attach(std::vector<Span>& spans, std::span<ConfigElement* const> elements, std::span<ConfigList* const> lists, std::span<ConfigListElement* const> listElements);
+    };
+}
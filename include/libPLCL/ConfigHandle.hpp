@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Reloading a configuration file while it's being read.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::ConfigHandle
+/// @brief The current contents of a configuration file, reloaded in the background when the file changes.
+/// @details Every successful load is published as an immutable snapshot. Readers take the current one with
+/// `snapshot()`, which only copies a shared pointer, and keep using it for as long as they like. A reload never blocks
+/// readers while it parses or verifies, the new snapshot replaces the old one in a single pointer swap, and the old
+/// tree is freed when its last reader lets go of it.
+///
+/// A load that fails, because the file can't be read, doesn't parse or doesn't match the template, leaves the current
+/// snapshot in place.
+///
+/// Watching uses inotify on the directory of the file, so files replaced by a rename, like most editors and
+/// deployment tools do, are picked up too. A reload starts when a writer closes the file or another file is renamed
+/// over it, never while it's only been created, so a half-written file isn't loaded. Where inotify isn't available,
+/// the modification time of the file is polled every `pollInterval`. The file is read rather than mapped, so it can
+/// be truncated while it's loaded.
+///
+/// @var PLCL::Config::ConfigHandle::pollInterval
+/// @brief How often the file is checked for changes when inotify isn't available.
+///
+/// @fn PLCL::Config::ConfigHandle::ConfigHandle(std::filesystem::path path, std::shared_ptr<const Validator> validator, bool strict)
+/// @brief Loads a configuration file.
+/// @param path The path of the file.
+/// @param validator The template every load is checked against, null to skip checking.
+/// @param strict Whether to report elements, lists and attributes that aren't in the template.
+/// @throws std::runtime_error If the file can't be loaded.
+///
+/// @fn std::shared_ptr<const PLCL::Config::ConfigRoot> PLCL::Config::ConfigHandle::snapshot() const
+/// @brief Returns the last configuration that was loaded successfully.
+///
+/// @fn void PLCL::Config::ConfigHandle::reload()
+/// @brief Loads the file again, on the calling thread.
+/// @throws std::runtime_error If the file can't be loaded, in which case the current snapshot is kept.
+///
+/// @fn void PLCL::Config::ConfigHandle::watch(ErrorHandler onError)
+/// @brief Starts reloading the file in the background whenever it changes.
+/// @details Watching stops when the handle is destroyed.
+/// @param onError Called on the watching thread with the reason a reload failed.
+/// @throws std::runtime_error If the file is already watched, or the watch can't be set up.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include "Config.hpp"
+#include "Validator.hpp"
+
+namespace PLCL::Config {
+    class ConfigHandle {
+    public:
+        using ErrorHandler = std::function<void(const std::exception& error)>;
+
+        static constexpr std::chrono::milliseconds pollInterval{500};
+
+        explicit ConfigHandle(std::filesystem::path path, std::shared_ptr<const Validator> validator = nullptr, bool strict = false);
+        ConfigHandle(const ConfigHandle&) = delete;
+        ConfigHandle& operator=(const ConfigHandle&) = delete;
+        ~ConfigHandle();
+
+        [[nodiscard]] std::shared_ptr<const ConfigRoot> snapshot() const {
+            return this->current.load(std::memory_order_acquire);
+        }
+
+        void reload();
+        void watch(ErrorHandler onError = {});
+
+    private:
+        std::filesystem::path path;
+        std::shared_ptr<const Validator> validator;
+        bool strict;
+        std::atomic<std::shared_ptr<const ConfigRoot>> current;
+        std::mutex reloadMutex;
+        int notify = -1;
+        int wake = -1;
+        std::jthread watcher;
+
+        void watchLoop(const std::stop_token& stop, const ErrorHandler& onError);
+    };
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Event-driven parsing of configurations.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::ConfigHandler
+/// @brief Receives the contents of a configuration as a sequence of events.
+/// @details `parse()` calls these as it reads tokens, nothing else is built along the way.
+/// Every event has an empty default implementation, so a handler only overrides the ones it cares about.
+/// The `Begin` events can return `Action::SkipSubtree`, in which case the parser fast-forwards to the end of that
+/// element or list without checking or reporting anything inside it, and the matching `End` event isn't sent.
+///
+/// @enum PLCL::Config::ConfigHandler::Action
+/// @brief What the parser should do after a `Begin` event.
+///
+/// @fn void PLCL::Config::ConfigHandler::onConfigName(std::string_view name)
+/// @brief Called once, with the name of the configuration.
+///
+/// @fn void PLCL::Config::ConfigHandler::onImport(const Lexer::Token& path)
+/// @brief Called for every import, with the string literal token of the imported path.
+///
+/// @fn PLCL::Config::ConfigHandler::Action PLCL::Config::ConfigHandler::onElementBegin(std::string_view type)
+/// @brief Called when an element starts.
+///
+/// @fn void PLCL::Config::ConfigHandler::onAttribute(std::string_view name, const Lexer::Token& value)
+/// @brief Called for every attribute of the current element.
+/// @details The value is a string, number or boolean literal token, `tokenValue()` converts it.
+///
+/// @fn void PLCL::Config::ConfigHandler::onElementEnd()
+/// @brief Called when the current element ends.
+///
+/// @fn PLCL::Config::ConfigHandler::Action PLCL::Config::ConfigHandler::onListBegin(std::string_view type)
+/// @brief Called when a list starts.
+///
+/// @fn PLCL::Config::ConfigHandler::Action PLCL::Config::ConfigHandler::onListElement(size_t id)
+/// @brief Called when an element of the current list starts.
+///
+/// @fn void PLCL::Config::ConfigHandler::onListElementEnd()
+/// @brief Called when the current list element ends.
+///
+/// @fn void PLCL::Config::ConfigHandler::onListEnd()
+/// @brief Called when the current list ends.
+///
+/// @fn void PLCL::Config::parse(Lexer::TokenStream& tokens, ConfigHandler& handler)
+/// @brief Parses a configuration, reporting its contents to `handler`.
+/// @param tokens The stream of tokens to parse.
+/// @param handler The handler to send events to.
+///
+/// @fn PLCL::Generic::Value PLCL::Config::tokenValue(const Lexer::Token& token, Generic::Allocator alloc)
+/// @brief Converts a literal token to the value it represents.
+/// @param token A string, number or boolean literal token.
+/// @param alloc The allocator for string values.
+/// @return The value of the token.
+
+#pragma once
+#include <string_view>
+#include "Generic.hpp"
+#include "Lexer.hpp"
+#include "Value.hpp"
+
+namespace PLCL::Config {
+    class ConfigHandler {
+    public:
+        enum class Action {
+            Continue,
+            SkipSubtree
+        };
+
+        virtual ~ConfigHandler() = default;
+
+        virtual void onConfigName(std::string_view /*name*/) {}
+        virtual void onImport(const Lexer::Token& /*path*/) {}
+        virtual Action onElementBegin(std::string_view /*type*/) { return Action::Continue; }
+        virtual void onAttribute(std::string_view /*name*/, const Lexer::Token& /*value*/) {}
+        virtual void onElementEnd() {}
+        virtual Action onListBegin(std::string_view /*type*/) { return Action::Continue; }
+        virtual Action onListElement(size_t /*id*/) { return Action::Continue; }
+        virtual void onListElementEnd() {}
+        virtual void onListEnd() {}
+    };
+
+    void parse(Lexer::TokenStream& tokens, ConfigHandler& handler);
+    Generic::Value tokenValue(const Lexer::Token& token, Generic::Allocator alloc);
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Looking up values in a configuration by path.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::ConfigIndex
+/// @brief Hash tables over a configuration tree, so a value can be found by its path without scanning.
+/// @details A path names an attribute by the elements and lists that lead to it, separated by dots, with the id of
+/// the list element in brackets after a list, e.g. `ExampleElement.InnerElements[0].hi` or `Servers[2].port`.
+/// Building the index walks the tree once. After that every segment of a path is a single hash lookup.
+///
+/// When a level has several elements or lists of the same type, or a list has several elements with the same id,
+/// the first one is used. The index keeps the arena of the tree alive, but it doesn't follow changes made to the tree
+/// after it was built.
+///
+/// @fn PLCL::Config::ConfigIndex::ConfigIndex(const ConfigRoot& root)
+/// @brief Indexes a configuration.
+/// @param root The configuration to index. Trees built by hand, without an arena, must outlive the index.
+///
+/// @fn const PLCL::Generic::Value* PLCL::Config::ConfigIndex::find(std::string_view path) const
+/// @brief Looks up an attribute.
+/// @param path The path of the attribute.
+/// @return The value of the attribute, or null if there's no attribute at that path.
+/// @throws std::runtime_error If the path is malformed.
+///
+/// @fn const PLCL::Config::ConfigElement* PLCL::Config::ConfigIndex::findElement(std::string_view path) const
+/// @brief Looks up an element.
+/// @param path The path of the element, a list element counts as the element it holds.
+/// @return The element, or null if there's no element at that path.
+/// @throws std::runtime_error If the path is malformed.
+///
+/// @fn T PLCL::Config::ConfigIndex::get(std::string_view path) const
+/// @brief Looks up an attribute that must exist and hold a `T`.
+/// @tparam T One of the alternatives of `Generic::Value`.
+/// @param path The path of the attribute.
+/// @return The value of the attribute.
+/// @throws std::runtime_error If the path is malformed, there's no attribute at that path, or it holds another type.
+
+#pragma once
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include "Config.hpp"
+#include "Generic.hpp"
+#include "Symbol.hpp"
+#include "Value.hpp"
+
+namespace PLCL::Config {
+    class ConfigIndex {
+    public:
+        explicit ConfigIndex(const ConfigRoot& root);
+
+        [[nodiscard]] const Generic::Value* find(std::string_view path) const;
+        [[nodiscard]] const ConfigElement* findElement(std::string_view path) const;
+
+        template <typename T>
+        [[nodiscard]] T get(std::string_view path) const {
+            const Generic::Value* value = this->find(path);
+            if (value == nullptr) {
+                throw std::runtime_error(std::format("No attribute at {}", path));
+            }
+            std::optional<T> result = Generic::get_if<T>(value);
+            if (!result) {
+                throw std::runtime_error(std::format("Attribute at {} holds another type", path));
+            }
+            return *result;
+        }
+
+    private:
+        // Children are keyed by their parent node, the root or an element, and their name.
+        struct Key {
+            const void* parent;
+            Symbol name;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const {
+                return std::hash<Symbol>{}(key.name) ^ (std::hash<const void*>{}(key.parent) * 0x9e3779b97f4a7c15);
+            }
+        };
+
+        struct IdKey {
+            const ConfigList* list;
+            size_t id;
+
+            bool operator==(const IdKey&) const = default;
+        };
+
+        struct IdKeyHash {
+            size_t operator()(const IdKey& key) const {
+                return std::hash<size_t>{}(key.id) ^ (std::hash<const void*>{}(key.list) * 0x9e3779b97f4a7c15);
+            }
+        };
+
+        const ConfigRoot* root;
+        std::shared_ptr<Generic::Arena> arena;
+        std::unordered_map<Key, const ConfigElement*, KeyHash> elements;
+        std::unordered_map<Key, const ConfigList*, KeyHash> lists;
+        std::unordered_map<Key, const Generic::Value*, KeyHash> attributes;
+        std::unordered_map<IdKey, const ConfigElement*, IdKeyHash> listElements;
+
+        void add(const void* parent, const std::pmr::vector<ConfigList*>& children);
+        void add(const ConfigElement* element);
+        const ConfigElement* step(const void* node, std::string_view segment) const;
+        const void* resolve(std::string_view path, std::string_view& last) const;
+    };
+}
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Paths compiled against a template, for reading the same values over and over.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::SlotLayout
+/// @brief A template with a slot numbered for every attribute a path can reach.
+/// @details Paths are written like for `ConfigIndex`, e.g. `ExampleElement.InnerElements[0].hi`, and a list segment
+/// picks the element of the configuration list with that id. Like the validator, the template gives the type of that
+/// element by the element types its list allows, which must be a single one. Every path leads to exactly one slot.
+/// The slots of the attributes of top-level and nested elements are numbered up front, those under a list element
+/// when a path first picks that id, so tables only have slots for the list elements of paths compiled before they
+/// were bound. Paths can be compiled and tables bound from several threads at once.
+///
+/// @fn PLCL::Config::SlotLayout::SlotLayout(const Template::TemplateRoot& configTemplate)
+/// @brief Numbers the attributes of a template.
+/// @param configTemplate The template to lay out, it isn't needed once this returns.
+///
+/// @fn PLCL::Config::SlotLayout::Slot PLCL::Config::SlotLayout::slot(std::string_view path) const
+/// @brief Finds the slot of a path.
+/// @param path The path of an attribute.
+/// @return The slot of the attribute, and the type the template gives it.
+/// @throws std::runtime_error If the path is malformed, the template has nothing at that path, or a list of the path
+/// allows several element types.
+///
+/// @fn PLCL::Config::SlotTable PLCL::Config::SlotLayout::bind(const ConfigRoot& config) const
+/// @brief Fills a table with the values of a configuration.
+/// @details The configuration is walked once, alongside the template. Elements and lists the template doesn't know
+/// about are skipped, and so are list elements no path picked or of another type than the template's. When a level
+/// has several elements, lists or list elements with the same id that match the same one of the template, only the
+/// first is used, like `ConfigIndex` does. The configuration is expected to have been checked against the template, its
+/// values aren't.
+/// @param config The configuration to read. Trees built by hand, without an arena, must outlive the table.
+/// @return A table with the value of every slot, or null for attributes the configuration doesn't set.
+///
+/// @class PLCL::Config::SlotTable
+/// @brief The values of one configuration, by slot of a `SlotLayout`.
+///
+/// @class PLCL::Config::ConfigPath
+/// @brief A path compiled against a `SlotLayout`, reading it from a `SlotTable` is a single indexed load.
+/// @tparam T `std::string_view`, `int64_t`, `Generic::float64_t` or `bool`, the type the template must give the
+/// attribute. Float paths read integer values too, like the validator accepts them.
+///
+/// @fn PLCL::Config::ConfigPath::ConfigPath(const SlotLayout& layout, std::string_view path)
+/// @brief Compiles a path.
+/// @param layout The layout to compile against, it must outlive the path.
+/// @param path The path of an attribute.
+/// @throws std::runtime_error If the path doesn't lead to an attribute of the template of type `T`.
+///
+/// @fn std::optional<T> PLCL::Config::ConfigPath::find(const SlotTable& table) const
+/// @brief Reads the attribute, if the configuration sets it.
+/// @throws std::runtime_error If the table comes from another layout or was bound before the path was compiled, or
+/// the value has the wrong type.
+///
+/// @fn T PLCL::Config::ConfigPath::get(const SlotTable& table) const
+/// @brief Reads an attribute that must be set.
+/// @throws std::runtime_error If the table comes from another layout or was bound before the path was compiled, the
+/// attribute isn't set, or the value has the wrong type.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Config.hpp"
+#include "Generic.hpp"
+#include "Symbol.hpp"
+#include "Template.hpp"
+#include "Value.hpp"
+
+namespace PLCL::Config {
+    class SlotTable;
+
+    class SlotLayout {
+    public:
+        struct Slot {
+            size_t index;
+            Template::AttributeType type;
+        };
+
+        explicit SlotLayout(const Template::TemplateRoot& configTemplate);
+
+        [[nodiscard]] Slot slot(std::string_view path) const;
+        [[nodiscard]] SlotTable bind(const ConfigRoot& config) const;
+
+    private:
+        class Binder;
+
+        // An element of the template, or the root for `shapes[0]`, which is the only one with elements.
+        struct Shape {
+            Symbol type;
+            std::vector<std::pair<Symbol, Template::AttributeType>> attributes;
+            std::unordered_map<Symbol, uint32_t> elements;
+            std::unordered_map<Symbol, uint32_t> lists;
+        };
+
+        // A list of the template, with the element types it allows.
+        struct ListShape {
+            std::unordered_map<Symbol, uint32_t> elements;
+        };
+
+        // A shape at one place in a configuration, `nodes[0]` is the root.
+        struct Node {
+            Symbol type;
+            std::unordered_map<Symbol, Slot> attributes;
+            std::unordered_map<Symbol, uint32_t> elements;
+            std::unordered_map<Symbol, uint32_t> lists;
+        };
+
+        // A list shape at one place in a configuration, with a node for every id a path picked.
+        struct List {
+            uint32_t shape;
+            std::unordered_map<size_t, uint32_t> elements;
+        };
+
+        std::vector<Shape> shapes;
+        std::vector<ListShape> listShapes;
+
+        // Compiling a path adds the list elements it picks, under `mutex`.
+        mutable std::shared_mutex mutex;
+        mutable std::vector<Node> nodes;
+        mutable std::vector<List> lists;
+        mutable size_t slots = 0;
+
+        uint32_t addShape(const Template::TemplateElement& element);
+        uint32_t addShape(const Template::TemplateList& list);
+        uint32_t instantiate(uint32_t shape) const;
+        std::optional<Slot> resolve(std::string_view path, bool add) const;
+    };
+
+    class SlotTable {
+    public:
+        SlotTable() = default;
+
+        [[nodiscard]] const Generic::Value* operator[](size_t index) const {
+            return this->values[index];
+        }
+
+        [[nodiscard]] const SlotLayout* layout() const {
+            return this->source;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return this->values.size();
+        }
+
+    private:
+        friend class SlotLayout;
+
+        const SlotLayout* source = nullptr;
+        std::shared_ptr<Generic::Arena> arena;
+        std::vector<const Generic::Value*> values;
+    };
+
+    template <typename T>
+    class ConfigPath {
+    public:
+        static_assert(std::is_same_v<T, std::string_view> || std::is_same_v<T, int64_t> || std::is_same_v<T, Generic::float64_t> || std::is_same_v<T, bool>,
+                      "ConfigPath reads std::string_view, int64_t, Generic::float64_t or bool");
+
+        ConfigPath(const SlotLayout& layout, std::string_view path) : ConfigPath(layout, path, layout.slot(path)) {}
+
+        [[nodiscard]] std::optional<T> find(const SlotTable& table) const {
+            if (table.layout() != this->layout) {
+                throw std::runtime_error(std::format("Path {} is read from a table of another layout", this->path));
+            }
+            if (this->index >= table.size()) {
+                throw std::runtime_error(std::format("Path {} is read from a table bound before it was compiled", this->path));
+            }
+            const Generic::Value* value = table[this->index];
+            if (value == nullptr) {
+                return std::nullopt;
+            }
+            if (std::optional<T> result = Generic::get_if<T>(value)) {
+                return result;
+            }
+            if constexpr (std::is_same_v<T, Generic::float64_t>) {
+                if (auto integer = Generic::get_if<int64_t>(value)) {
+                    return static_cast<Generic::float64_t>(*integer);
+                }
+            }
+            throw std::runtime_error(std::format("Attribute at {} doesn't hold a value of type {}", this->path, Template::attributeTypeToString(expectedType())));
+        }
+
+        [[nodiscard]] T get(const SlotTable& table) const {
+            std::optional<T> value = this->find(table);
+            if (!value.has_value()) {
+                throw std::runtime_error(std::format("No attribute at {}", this->path));
+            }
+            return *value;
+        }
+
+    private:
+        const SlotLayout* layout;
+        size_t index;
+        std::string path;
+
+        ConfigPath(const SlotLayout& layout, std::string_view path, SlotLayout::Slot slot) : layout(&layout), index(slot.index), path(path) {
+            if (slot.type != expectedType()) {
+                throw std::runtime_error(std::format("Attribute at {} has type {} in the template, not {}", path, Template::attributeTypeToString(slot.type), Template::attributeTypeToString(expectedType())));
+            }
+        }
+
+        static constexpr Template::AttributeType expectedType() {
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                return Template::AttributeType::String;
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                return Template::AttributeType::Integer;
+            } else if constexpr (std::is_same_v<T, Generic::float64_t>) {
+                return Template::AttributeType::Float;
+            } else {
+                return Template::AttributeType::Boolean;
+            }
+        }
+    };
+}
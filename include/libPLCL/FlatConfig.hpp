@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Parsing into a flat, index-based configuration document.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @struct PLCL::Config::FlatConfig
+/// @brief A configuration stored as contiguous arrays instead of a tree of pointers.
+/// @details Every kind of node has its own set of parallel arrays, one array per field, and nodes refer to each other
+/// with 32-bit indices. The children of a node are always stored next to each other, so they're described by a `Range`
+/// and walking them is a linear scan instead of a pointer chase.
+/// Strings (names, types and imports) are stored once in `strings` and referred to by offset and length. The strings
+/// of attribute values are in `arena`, where `Generic::Value` can refer to them.
+/// The pointer tree (`ConfigRoot`) is still available through `toTree()`.
+///
+/// @struct PLCL::Config::FlatConfig::Range
+/// @brief A range of consecutive indices into one of the arrays.
+///
+/// @var PLCL::Config::FlatConfig::Range::begin
+/// @brief The first index in the range.
+///
+/// @var PLCL::Config::FlatConfig::Range::count
+/// @brief The number of indices in the range.
+///
+/// @struct PLCL::Config::FlatConfig::String
+/// @brief A string stored in `strings`.
+///
+/// @var PLCL::Config::FlatConfig::String::offset
+/// @brief The offset of the string in `strings`.
+///
+/// @var PLCL::Config::FlatConfig::String::length
+/// @brief The length of the string.
+///
+/// @var PLCL::Config::FlatConfig::noElement
+/// @brief The value of `listElementElements` for a list element without an element.
+///
+/// @var PLCL::Config::FlatConfig::strings
+/// @brief The storage for every name, type and import in the configuration.
+///
+/// @var PLCL::Config::FlatConfig::arena
+/// @brief The storage for the strings of attribute values, shared by copies of the configuration.
+///
+/// @var PLCL::Config::FlatConfig::name
+/// @brief The name of the configuration.
+///
+/// @var PLCL::Config::FlatConfig::imports
+/// @brief The list of imported templates.
+///
+/// @var PLCL::Config::FlatConfig::rootElements
+/// @brief The elements in the top level of the configuration, as a range of element indices.
+///
+/// @var PLCL::Config::FlatConfig::rootLists
+/// @brief The lists in the top level of the configuration, as a range of list indices.
+///
+/// @var PLCL::Config::FlatConfig::elementTypes
+/// @brief The type (name) of each element.
+///
+/// @var PLCL::Config::FlatConfig::elementAttributes
+/// @brief The attributes of each element, as a range of attribute indices.
+///
+/// @var PLCL::Config::FlatConfig::elementLists
+/// @brief The lists in each element, as a range of list indices.
+///
+/// @var PLCL::Config::FlatConfig::attributeNames
+/// @brief The name of each attribute.
+///
+/// @var PLCL::Config::FlatConfig::attributeValues
+/// @brief The value of each attribute.
+///
+/// @var PLCL::Config::FlatConfig::listTypes
+/// @brief The type (name) of each list.
+///
+/// @var PLCL::Config::FlatConfig::listElements
+/// @brief The elements of each list, as a range of list element indices.
+///
+/// @var PLCL::Config::FlatConfig::listElementIds
+/// @brief The id of each list element.
+///
+/// @var PLCL::Config::FlatConfig::listElementElements
+/// @brief The element index of each list element, or `noElement`.
+///
+/// @fn PLCL::Config::FlatConfig::FlatConfig()
+/// @brief Default constructor.
+///
+/// @fn PLCL::Config::FlatConfig::FlatConfig(Lexer::TokenStream& tokens)
+/// @brief Constructor that parses tokens from the lexer.
+/// @param tokens The stream of tokens to parse.
+///
+/// @fn PLCL::Config::FlatConfig::FlatConfig(const ConfigRoot& root)
+/// @brief Constructor that flattens a configuration tree.
+/// @param root The configuration to flatten.
+///
+/// @fn PLCL::Config::FlatConfig PLCL::Config::FlatConfig::fromString(std::string_view input)
+/// @brief Parses a configuration from a string.
+/// @param input The string to parse.
+/// @return The parsed configuration.
+///
+/// @fn PLCL::Config::FlatConfig PLCL::Config::FlatConfig::fromFile(const std::filesystem::path& path)
+/// @brief Parses a configuration from a file.
+/// @details The file is lexed in place, see `SourceFile`. It isn't needed once this returns.
+/// @param path The path of the file to parse.
+/// @return The parsed configuration.
+///
+/// @fn std::string_view PLCL::Config::FlatConfig::string(String string) const
+/// @brief Returns the contents of a string stored in `strings`.
+/// @param string The string to look up.
+/// @return A view into `strings`, valid until the configuration is modified.
+///
+/// @fn PLCL::Config::ConfigRoot PLCL::Config::FlatConfig::toTree() const
+/// @brief Builds the equivalent configuration tree.
+/// @return The configuration as a tree, allocated from a new arena.
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Config.hpp"
+#include "Generic.hpp"
+#include "Lexer.hpp"
+#include "Value.hpp"
+
+namespace PLCL::Config {
+    struct FlatConfig {
+        struct Range {
+            uint32_t begin = 0;
+            uint32_t count = 0;
+        };
+
+        struct String {
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+
+        static constexpr uint32_t noElement = UINT32_MAX;
+
+        std::string strings;
+        std::shared_ptr<Generic::Arena> arena;
+        String name;
+        std::vector<String> imports;
+        Range rootElements;
+        Range rootLists;
+
+        std::vector<String> elementTypes;
+        std::vector<Range> elementAttributes;
+        std::vector<Range> elementLists;
+
+        std::vector<String> attributeNames;
+        std::vector<Generic::Value> attributeValues;
+
+        std::vector<String> listTypes;
+        std::vector<Range> listElements;
+
+        std::vector<size_t> listElementIds;
+        std::vector<uint32_t> listElementElements;
+
+        FlatConfig() = default;
+        explicit FlatConfig(Lexer::TokenStream& tokens);
+        explicit FlatConfig(const ConfigRoot& root);
+
+        [[maybe_unused]] static FlatConfig fromString(std::string_view input);
+        [[maybe_unused]] static FlatConfig fromFile(const std::filesystem::path& path);
+        [[nodiscard]] std::string_view string(String string) const {
+            return std::string_view(this->strings).substr(string.offset, string.length);
+        }
+        [[maybe_unused]] ConfigRoot toTree() const;
+    };
+}
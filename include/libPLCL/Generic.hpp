@@ -11,9 +11,18 @@
 /// @brief The 64-bit floating point type.
 /// @details It's either `std::float64_t` or `double` depending on the compiler's support for the former.
 ///
-/// @var PLCL::Generic::ValueType
-/// @brief A variant type that can hold a string, an integer, a floating point number, or a boolean.
-/// @details It's used to store the value of a key-value pair in a configuration file.
+/// @var PLCL::Generic::Arena
+/// @brief The memory resource parsed trees are allocated from.
+/// @details Nodes and the strings they own are never freed one by one, the whole arena is released at once.
+///
+/// @var PLCL::Generic::Allocator
+/// @brief The allocator handed down to every node while parsing.
+///
+/// @struct PLCL::Generic::StringHash
+/// @brief A transparent string hash, so tables keyed by strings can be searched with a `std::string_view`.
+///
+/// @var PLCL::Generic::StringTable
+/// @brief A hash table keyed by strings that can be searched without allocating.
 ///
 /// @fn PLCL::Generic::iequals
 /// @brief A function for comparing two strings in a case-insensitive manner.
@@ -34,10 +43,14 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
 #include <stdexcept>
 #include <stdfloat>
+#include <string>
 #include <string_view>
-#include <variant>
+#include <unordered_map>
 
 namespace PLCL::Generic {
     #if __STDCPP_FLOAT64_T__ == 1
@@ -50,7 +63,18 @@ namespace PLCL::Generic {
         #endif
     #endif
     
-    using ValueType = std::variant<std::string, int64_t, float64_t, bool>;
+    using Arena = std::pmr::monotonic_buffer_resource;
+    using Allocator = std::pmr::polymorphic_allocator<>;
+
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    template <typename T>
+    using StringTable = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
 
     inline static bool iequals(std::string_view lhs, std::string_view rhs) {
         return std::ranges::equal(lhs, rhs, [](unsigned char a, unsigned char b) {
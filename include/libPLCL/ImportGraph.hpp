@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Loading a configuration together with everything it imports.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::ImportGraph
+/// @brief A configuration and every configuration it imports, directly or not, each loaded once.
+/// @details An import is looked up relative to the directory of the file that imports it, then in every search path
+/// in order. When it has no extension, `.plcl` is tried after the name as written. Files are told apart by their
+/// canonical path, so a file reached through several importers, or through different relative paths, is parsed only
+/// once. Loading goes level by level, every file of a level is parsed in parallel, then their imports make up the
+/// next level.
+///
+/// @fn PLCL::Config::ImportGraph::ImportGraph(const std::filesystem::path& path, std::vector<std::filesystem::path> searchPaths, bool parallel)
+/// @brief Loads a configuration and its imports.
+/// @param path The path of the configuration.
+/// @param searchPaths The directories to look for imports in, after the directory of the importing file.
+/// @param parallel Whether to parse the files of a level on several threads.
+/// @throws std::runtime_error If a file can't be read or parsed, an import can't be found, or the imports form a
+/// cycle.
+///
+/// @fn const std::vector<PLCL::Config::ImportGraph::File>& PLCL::Config::ImportGraph::files() const
+/// @brief Returns every loaded file, the configuration passed to the constructor first.
+///
+/// @fn PLCL::Config::ConfigRoot PLCL::Config::ImportGraph::merged() const
+/// @brief Puts every file into a single configuration.
+/// @details The top-level elements and lists of a file come before those of every file it imports, directly or not,
+/// so lookups that use the first match, like `ConfigIndex` and `SlotLayout::bind()`, see the values of an importing
+/// file over the ones it imports, even when another file imports them too. Files that don't import one another come in
+/// depth-first order of the imports as written, so of two such files the one imported first wins. For instance if A
+/// imports B and C, and C imports B, the order is A, C, B.
+/// The nodes are shared with the files, not copied, and the result keeps all of them alive on its own. It has the
+/// name of the first file and no imports.
+/// @return The merged configuration.
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+#include "Config.hpp"
+
+namespace PLCL::Config {
+    class ImportGraph {
+    public:
+        struct File {
+            std::filesystem::path path;
+            ConfigRoot root;
+            // Indices into `files()`, in the order of the imports in the file.
+            std::vector<size_t> imports;
+        };
+
+        explicit ImportGraph(const std::filesystem::path& path, std::vector<std::filesystem::path> searchPaths = {}, bool parallel = true);
+
+        [[nodiscard]] const std::vector<File>& files() const {
+            return this->nodes;
+        }
+
+        [[nodiscard]] ConfigRoot merged() const;
+
+    private:
+        std::vector<std::filesystem::path> searchPaths;
+        std::vector<File> nodes;
+
+        [[nodiscard]] std::filesystem::path resolve(const std::filesystem::path& importer, std::string_view import) const;
+        void checkCycles() const;
+        [[nodiscard]] std::vector<size_t> mergeOrder() const;
+    };
+}
@@ -8,6 +8,7 @@
 /// @brief A class that turns input into tokens
 /// @details The lexer is responsible for turning the input into tokens that the parser can understand.
 /// It does this by reading the input character by character and determining what kind of token it is.
+/// Whitespace, comments and the bodies of string literals are skipped in blocks with the kernels from `Scanner.hpp`.
 ///
 /// @enum PLCL::Lexer::TokenType
 /// @brief The different types of tokens that the lexer can produce
@@ -20,7 +21,8 @@
 ///
 /// @var PLCL::Lexer::Token::value
 /// @brief The value of the token
-/// @details The value of the token is the actual string that was read from the input
+/// @details The value of the token is a view into the input that the lexer was constructed with.
+/// For string literals it's the raw text between the quotes, escapes are left as they are (see `unescaped()`).
 /// 
 /// @var PLCL::Lexer::Token::line 
 /// @brief The line number where the token was found
@@ -28,23 +30,95 @@
 /// @var PLCL::Lexer::Token::column
 /// @brief The column number where the token was found
 ///
-/// @fn PLCL::Lexer::Lexer(std::string input)
+/// @var PLCL::Lexer::Token::escaped
+/// @brief Whether the value of a string literal contains escape sequences
+///
+/// @var PLCL::Lexer::Token::offset
+/// @brief The byte offset of the first character of the token in the input
+/// @details For `EndOfFile` it's the size of the input.
+///
+/// @var PLCL::Lexer::Token::isFloat
+/// @brief Whether a number literal has a fractional part, its value is then in `floatValue`, else in `integerValue`
+///
+/// @var PLCL::Lexer::Token::integerValue
+/// @brief The value of an integer number literal, converted once by the lexer
+///
+/// @var PLCL::Lexer::Token::floatValue
+/// @brief The value of a number literal with a fractional part, converted once by the lexer
+///
+/// @fn std::string PLCL::Lexer::Token::unescaped() const
+/// @brief Returns the value of the token with escape sequences decoded
+/// @details Only allocates, and only decodes, when the token is a string literal that actually contains an escape.
+/// @return The decoded value
+///
+/// @fn std::pmr::string PLCL::Lexer::Token::unescaped(const std::pmr::polymorphic_allocator<>& alloc) const
+/// @brief Returns the value of the token with escape sequences decoded, allocated with `alloc`
+/// @param alloc The allocator for the returned string
+/// @return The decoded value
+///
+/// @fn PLCL::Lexer::Lexer(std::string_view input)
 /// @brief Constructs a lexer with the given input
+/// @details The input is borrowed, not copied. It must outlive the lexer and every token the lexer produces.
 ///
-/// @fn std::vector<Token> PLCL::Lexer::lex()
+/// @fn std::vector<Token> PLCL::Lexer::lex(bool parallel)
 /// @brief Turns the input into tokens
+/// @details In parallel mode, inputs of at least `parallelThreshold` bytes are split into chunks at newlines that aren't
+/// inside a string literal or a comment, and the chunks are lexed on several threads. The tokens are the same as in
+/// serial mode, including their lines and columns. Parallel mode only applies to a lexer that hasn't produced any
+/// tokens yet.
+/// @param parallel Whether to use all the available cores
 /// @return A vector of tokens 
 ///
+/// @var PLCL::Lexer::parallelThreshold
+/// @brief The input size, in bytes, from which `lex(true)` splits the work
+///
+/// @fn PLCL::Lexer::Token PLCL::Lexer::pull()
+/// @brief Lexes the next token
+/// @details Returns `EndOfFile` once the input is exhausted, and keeps returning it after that.
+/// @return The next token
+/// @throws std::runtime_error If a string literal isn't terminated, or a number literal is malformed or doesn't fit
+/// in 64 bits
+///
+/// @class PLCL::Lexer::TokenStream
+/// @brief A one-token window over the tokens the parser is consuming
+/// @details It either pulls tokens from a lexer on demand, so the token vector is never materialized,
+/// or walks a vector produced by `lex()`. Once the end is reached it keeps returning the `EndOfFile` token.
+///
+/// @fn PLCL::Lexer::TokenStream::TokenStream(Lexer& lexer)
+/// @brief Constructs a stream that pulls tokens from the lexer as they're needed
+/// @param lexer The lexer to pull from, it must outlive the stream
+///
+/// @fn PLCL::Lexer::TokenStream::TokenStream(const std::vector<Token>& tokens)
+/// @brief Constructs a stream over tokens that were already lexed
+/// @param tokens The tokens to walk, they must outlive the stream and end with `EndOfFile`
+///
+/// @fn const PLCL::Lexer::Token& PLCL::Lexer::TokenStream::peek() const
+/// @brief Returns the current token without consuming it
+///
+/// @fn void PLCL::Lexer::TokenStream::advance()
+/// @brief Consumes the current token
+///
+/// @fn size_t PLCL::Lexer::TokenStream::sizeHint() const
+/// @brief Returns a rough estimate, in bytes, of how big a tree parsed from the stream will be
+///
 /// @fn std::string PLCL::Lexer::tokenTypeToString(TokenType type)
 /// @brief Converts a token type to a string 
 /// @param type The token type to convert 
 /// @return The string representation of the token type
 
 #pragma once
+#include <cstdint>
+#include <memory_resource>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "Generic.hpp"
 
 namespace PLCL {
+    namespace Scanner {
+        struct Result;
+    }
+
     class Lexer {
     public:
         enum class TokenType {
@@ -85,18 +159,45 @@ namespace PLCL {
 
         struct Token {
             TokenType type;
-            std::string value;
+            std::string_view value;
             size_t line;
             size_t column;
+            bool escaped = false;
+            size_t offset = 0;
+            bool isFloat = false;
+            int64_t integerValue = 0;
+            Generic::float64_t floatValue = 0;
+
+            [[nodiscard]] std::string unescaped() const;
+            [[nodiscard]] std::pmr::string unescaped(const std::pmr::polymorphic_allocator<>& alloc) const;
+        };
+
+        explicit Lexer(std::string_view input) : input(input) {};
+
+        class TokenStream {
+        public:
+            explicit TokenStream(Lexer& lexer);
+            explicit TokenStream(const std::vector<Token>& tokens);
+
+            [[nodiscard]] const Token& peek() const { return this->current; }
+            void advance();
+            [[nodiscard]] size_t sizeHint() const;
+
+        private:
+            Lexer* lexer = nullptr;
+            const std::vector<Token>* tokens = nullptr;
+            size_t index = {};
+            Token current;
         };
 
-        explicit Lexer(std::string input) : input(std::move(input)) {};
+        static constexpr size_t parallelThreshold = 1024 * 1024;
 
-        std::vector<Token> lex();
+        std::vector<Token> lex(bool parallel = false);
+        Token pull();
         static std::string tokenTypeToString(TokenType type);
 
     private:
-        std::string input;
+        std::string_view input;
         size_t index = {};
         size_t line = {1};
         size_t column = {1};
@@ -104,8 +205,11 @@ namespace PLCL {
         unsigned char peek();
         unsigned char next();
         bool eof();
+        void advance(const Scanner::Result& result);
         void skipWhitespace();
         void skipComment();
         Token nextToken();
+        Token numberLiteral();
+        std::vector<Token> lexParallel();
     };
 }
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief A minimal fork-join helper for the parts of the library that can use several cores
+/// @attention This file is not meant to be included by the end user.
+///
+/// @namespace PLCL::Parallel
+/// @brief Running independent pieces of work on several threads.
+///
+/// @fn size_t PLCL::Parallel::threadCount()
+/// @brief Returns the number of threads `forEach()` uses at most.
+///
+/// @fn void PLCL::Parallel::forEach(size_t count, Work&& work)
+/// @brief Calls `work(i)` for every `i` in `[0, count)`, spread over up to `threadCount()` threads.
+/// @details The calling thread takes part, and the call returns once every index is done. Indices are handed out one
+/// at a time, so uneven pieces of work balance out. If `work` throws, the remaining indices are dropped and the first
+/// exception is rethrown.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PLCL::Parallel {
+    inline size_t threadCount() {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    template <typename Work>
+    void forEach(size_t count, Work&& work) {
+        std::atomic<size_t> next = 0;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto run = [&] {
+            try {
+                for (size_t i = next++; i < count; i = next++) {
+                    work(i);
+                }
+            } catch (...) {
+                std::scoped_lock lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        };
+        {
+            std::vector<std::jthread> workers;
+            for (size_t i = 1; i < std::min(threadCount(), count); i++) {
+                workers.emplace_back(run);
+            }
+            run();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief An on-disk cache of parsed files
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::ParseCache
+/// @brief Keeps the binary form of every file it parses in a directory, so later loads of the same bytes skip the
+/// lexer and the parser
+/// @details Entries are named after a hash of the source bytes, their size, the version of the binary format and
+/// the kind of tree, so editing a file or upgrading to a library with another format simply misses the old entries.
+/// Entries are written to a temporary file and renamed into place, several processes can share a directory. The
+/// cache is only ever a shortcut: an entry that can't be decoded is removed and the file is parsed as if it wasn't
+/// there, and failing to write an entry doesn't fail the load.
+///
+/// @fn PLCL::ParseCache::ParseCache(std::filesystem::path directory)
+/// @brief Uses a directory as the cache, creating it if needed
+/// @param directory The directory to keep the entries in
+/// @throws std::filesystem::filesystem_error If the directory can't be created
+///
+/// @fn PLCL::Config::ConfigRoot PLCL::ParseCache::loadConfig(const std::filesystem::path& path) const
+/// @brief Loads a configuration from the cache, or parses it and caches the result
+/// @param path The path of the configuration
+/// @return The configuration
+/// @throws std::runtime_error If the file can't be read or doesn't parse
+///
+/// @fn PLCL::Template::TemplateRoot PLCL::ParseCache::loadTemplate(const std::filesystem::path& path) const
+/// @brief Loads a template from the cache, or parses it and caches the result
+/// @param path The path of the template
+/// @return The template
+/// @throws std::runtime_error If the file can't be read or doesn't parse
+///
+/// @fn uint64_t PLCL::ParseCache::hash(std::string_view data)
+/// @brief The hash entries are keyed by, a non-cryptographic 64 bit hash that reads 8 bytes at a time
+/// @param data The bytes to hash
+/// @return The hash of the bytes
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include "Config.hpp"
+#include "Template.hpp"
+
+namespace PLCL {
+    class ParseCache {
+    public:
+        explicit ParseCache(std::filesystem::path directory);
+
+        [[nodiscard]] Config::ConfigRoot loadConfig(const std::filesystem::path& path) const;
+        [[nodiscard]] Template::TemplateRoot loadTemplate(const std::filesystem::path& path) const;
+
+        [[nodiscard]] static uint64_t hash(std::string_view data);
+
+    private:
+        std::filesystem::path directory;
+
+        template <typename Root>
+        Root load(const std::filesystem::path& path, char kind) const;
+        [[nodiscard]] std::filesystem::path entry(std::string_view source, char kind) const;
+        void store(const std::filesystem::path& entry, std::string_view data) const;
+    };
+}
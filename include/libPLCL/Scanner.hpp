@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Vectorized scanning kernels used by the lexer
+/// @attention This file is not meant to be included by the end user.
+///
+/// @namespace PLCL::Scanner
+/// @brief Scanning kernels that skip over runs of bytes the lexer doesn't need to look at one by one.
+/// @details Every kernel has an AVX2, an SSE2 and a portable scalar implementation.
+/// The best one supported by the CPU is selected once, at runtime.
+///
+/// @struct PLCL::Scanner::Result
+/// @brief Where a scan stopped, and how many lines it skipped on the way.
+///
+/// @var PLCL::Scanner::Result::index
+/// @brief The index of the byte the scan stopped at, or the size of the input if it ran off the end.
+///
+/// @var PLCL::Scanner::Result::newlines
+/// @brief The number of newlines between the start of the scan and `index`.
+///
+/// @var PLCL::Scanner::Result::lineStart
+/// @brief The index right after the last skipped newline, or `npos` if no newline was skipped.
+///
+/// @fn PLCL::Scanner::Result PLCL::Scanner::skipWhitespace(std::string_view input, size_t index)
+/// @brief Finds the first byte at or after `index` that isn't whitespace.
+/// @param input The input to scan.
+/// @param index The index to start scanning from.
+/// @return Where the scan stopped.
+///
+/// @fn size_t PLCL::Scanner::findNewline(std::string_view input, size_t index)
+/// @brief Finds the first newline at or after `index`.
+/// @param input The input to scan.
+/// @param index The index to start scanning from.
+/// @return The index of the newline, or the size of the input if there is none.
+///
+/// @fn PLCL::Scanner::Result PLCL::Scanner::findQuoteOrBackslash(std::string_view input, size_t index)
+/// @brief Finds the first `"` or `\` at or after `index`, which is where a string literal either ends or escapes.
+/// @param input The input to scan.
+/// @param index The index to start scanning from.
+/// @return Where the scan stopped.
+///
+/// @fn std::string_view PLCL::Scanner::implementation()
+/// @brief Returns the name of the selected implementation, one of "avx2", "sse2" or "scalar".
+
+#pragma once
+#include <string_view>
+
+namespace PLCL::Scanner {
+    struct Result {
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        size_t index;
+        size_t newlines = 0;
+        size_t lineStart = npos;
+    };
+
+    Result skipWhitespace(std::string_view input, size_t index);
+    size_t findNewline(std::string_view input, size_t index);
+    Result findQuoteOrBackslash(std::string_view input, size_t index);
+    std::string_view implementation();
+}
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Writing configurations and templates out as text without building intermediate strings.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Sink
+/// @brief Where a `Serializer` sends its output.
+/// @details The serializer buffers its output and hands it over in large pieces, so a sink is called rarely and
+/// doesn't need its own buffering.
+///
+/// @fn void PLCL::Sink::write(std::string_view data)
+/// @brief Takes the next piece of output.
+///
+/// @fn void PLCL::Sink::writeAll(std::span<const std::string_view> pieces)
+/// @brief Takes several pieces of output at once, in order.
+/// @details By default every piece is passed to `write()` in turn, sinks that can take them in one call override it.
+///
+/// @class PLCL::StringSink
+/// @brief Appends the output to a string.
+///
+/// @class PLCL::StreamSink
+/// @brief Writes the output to a `std::ostream`.
+///
+/// @class PLCL::FileSink
+/// @brief Writes the output to a file descriptor, which stays owned by the caller.
+/// @details Short writes are retried, and `writeAll()` hands all the pieces to `writev` at once. It's only available
+/// where POSIX `write` is.
+/// @throws std::runtime_error From `write()`, if the descriptor can't be written to.
+///
+/// @class PLCL::IteratorSink
+/// @brief Copies the output through an output iterator.
+/// @tparam Iterator An output iterator of `char`.
+///
+/// @fn Iterator PLCL::IteratorSink::iterator() const
+/// @brief Returns the iterator past the last character written.
+///
+/// @class PLCL::Serializer
+/// @brief Writes trees in the same text as their `toString()`, straight into a sink.
+/// @details Every line is appended to a single buffer that's handed to the sink once it's full, or when the node
+/// passed to `write()` is done, and numbers are formatted with `std::to_chars`. Nothing is allocated per node or per
+/// line.
+///
+/// @fn PLCL::Serializer::Serializer(Sink& sink, size_t indent)
+/// @brief Starts writing to a sink.
+/// @param sink The sink to write to, it must outlive the serializer.
+/// @param indent The number of spaces each level of nesting is indented by.
+///
+/// @var PLCL::Serializer::chunkSize
+/// @brief The number of top-level elements, or of elements of a top-level list, serialized together in parallel mode.
+///
+/// @fn void PLCL::Serializer::write(const Config::ConfigRoot& root, bool parallel)
+/// @brief Writes a whole configuration, then flushes it to the sink.
+/// @details In parallel mode the top-level elements, and the elements of top-level lists, are serialized in chunks of
+/// `chunkSize` on a pool of threads, each into its own buffer, then all the buffers are given to the sink in order with
+/// a single `writeAll()`. The output is the same as in serial mode.
+/// @param root The configuration to write.
+/// @param parallel Whether to use all the available cores.
+///
+/// @fn void PLCL::Serializer::write(const Template::TemplateRoot& root)
+/// @brief Writes a whole template, then flushes it to the sink.
+///
+/// @fn void PLCL::Serializer::write(const Config::ConfigElement& element, size_t indentStart)
+/// @brief Writes a single node, with its first line indented by `indentStart` spaces, then flushes it to the sink.
+/// @details The other overloads taking an `indentStart` do the same for the other kinds of nodes.
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "Config.hpp"
+#include "Generic.hpp"
+#include "Template.hpp"
+#include "Value.hpp"
+
+namespace PLCL {
+    class Sink {
+    public:
+        virtual ~Sink() = default;
+
+        virtual void write(std::string_view data) = 0;
+
+        virtual void writeAll(std::span<const std::string_view> pieces) {
+            for (std::string_view piece : pieces) {
+                this->write(piece);
+            }
+        }
+    };
+
+    class StringSink final : public Sink {
+    public:
+        explicit StringSink(std::string& out) : out(out) {}
+
+        void write(std::string_view data) override {
+            this->out.append(data);
+        }
+
+    private:
+        std::string& out;
+    };
+
+    class StreamSink final : public Sink {
+    public:
+        explicit StreamSink(std::ostream& out) : out(out) {}
+
+        void write(std::string_view data) override {
+            this->out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+    private:
+        std::ostream& out;
+    };
+
+    class FileSink final : public Sink {
+    public:
+        explicit FileSink(int fd) : fd(fd) {}
+
+        void write(std::string_view data) override;
+        void writeAll(std::span<const std::string_view> pieces) override;
+
+    private:
+        int fd;
+    };
+
+    template <typename Iterator>
+    class IteratorSink final : public Sink {
+    public:
+        explicit IteratorSink(Iterator out) : out(std::move(out)) {}
+
+        void write(std::string_view data) override {
+            this->out = std::copy(data.begin(), data.end(), std::move(this->out));
+        }
+
+        [[nodiscard]] Iterator iterator() const {
+            return this->out;
+        }
+
+    private:
+        Iterator out;
+    };
+
+    class Serializer {
+    public:
+        static constexpr size_t bufferSize = 64 * 1024;
+        static constexpr size_t chunkSize = 1024;
+
+        Serializer(Sink& sink, size_t indent);
+
+        void write(const Config::ConfigRoot& root, bool parallel = false);
+        void write(const Config::ConfigList& list, size_t indentStart);
+        void write(const Config::ConfigListElement& listElement, size_t indentStart);
+        void write(const Config::ConfigElement& element, size_t indentStart);
+        void write(const Config::ConfigElementAttribute& attribute, size_t indentStart);
+
+        void write(const Template::TemplateRoot& root);
+        void write(const Template::TemplateList& list, size_t indentStart);
+        void write(const Template::TemplateListElement& listElement, size_t indentStart);
+        void write(const Template::TemplateElement& element, size_t indentStart);
+        void write(const Template::TemplateAttribute& attribute, size_t indentStart);
+        void write(const Template::TemplateOptions& options, size_t indentStart, Template::OptionsType optionsType);
+        void write(const Template::TemplateOption& option, size_t indentStart);
+
+    private:
+        Sink& sink;
+        size_t indent;
+        std::string buffer;
+
+        void header(const Config::ConfigRoot& root);
+        void node(const Config::ConfigRoot& root);
+        void node(const Config::ConfigList& list, size_t indentStart);
+        void node(const Config::ConfigListElement& listElement, size_t indentStart);
+        void node(const Config::ConfigElement& element, size_t indentStart);
+        void node(const Config::ConfigElementAttribute& attribute, size_t indentStart);
+
+        void node(const Template::TemplateRoot& root);
+        void node(const Template::TemplateList& list, size_t indentStart);
+        void node(const Template::TemplateListElement& listElement, size_t indentStart);
+        void node(const Template::TemplateElement& element, size_t indentStart);
+        void node(const Template::TemplateAttribute& attribute, size_t indentStart);
+        void node(const Template::TemplateOptions& options, size_t indentStart, Template::OptionsType optionsType);
+        void node(const Template::TemplateOption& option, size_t indentStart);
+
+        void append(std::string_view text);
+        void spaces(size_t count);
+        void line(size_t indentStart, std::string_view keyword, std::string_view name);
+        void value(const Generic::Value& value);
+        void flush();
+    };
+}
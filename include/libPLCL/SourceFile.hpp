@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Loading source files without copying them
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::SourceFile
+/// @brief The contents of a file, kept in memory for as long as the object lives
+/// @details Files of at least `mapThreshold` bytes are memory-mapped read-only, so their bytes are never copied.
+/// Smaller files are read into a buffer with a single `read`, which is cheaper than setting up and tearing down a
+/// mapping for a few pages. Either way `view()` can be handed straight to the lexer.
+///
+/// @var PLCL::SourceFile::mapThreshold
+/// @brief The size, in bytes, from which files are mapped instead of read
+///
+/// @fn PLCL::SourceFile::SourceFile(const std::filesystem::path& path, bool map)
+/// @brief Loads a file
+/// @param path The path of the file to load
+/// @param map Whether large files may be mapped. Reading a mapping past the end of a file that was truncated since
+/// raises `SIGBUS`, so files that can be rewritten while they're loaded must be read instead.
+/// @throws std::runtime_error If the file can't be opened or read
+///
+/// @fn std::string_view PLCL::SourceFile::view() const
+/// @brief Returns the contents of the file
+/// @return A view that's valid for as long as the object lives
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace PLCL {
+    class SourceFile {
+    public:
+        static constexpr size_t mapThreshold = 64 * 1024;
+
+        explicit SourceFile(const std::filesystem::path& path, bool map = true);
+        SourceFile(const SourceFile&) = delete;
+        SourceFile& operator=(const SourceFile&) = delete;
+        SourceFile(SourceFile&& other) noexcept;
+        SourceFile& operator=(SourceFile&& other) noexcept;
+        ~SourceFile();
+
+        [[nodiscard]] std::string_view view() const {
+            return {this->data, this->size};
+        }
+
+    private:
+        const char* data = nullptr;
+        size_t size = 0;
+        bool mapped = false;
+        std::unique_ptr<char[]> buffer;
+    };
+}
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Interned names of elements, lists and attributes.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Symbol
+/// @brief A name stored once for the whole process, and compared by identity.
+/// @details Configurations use the same few element types and attribute names over and over, so the trees store them
+/// as symbols: every distinct name is copied once into a process-wide table and given a small id, and a symbol is a
+/// single pointer to its entry. Comparing two symbols compares the pointers, hashing one hashes its id, and reading its
+/// text doesn't touch the table.
+///
+/// The table is shared by every document and template, so symbols from different trees can be compared too, e.g. by
+/// `Validator`. It only grows, names are never removed. Looking a name up is lock-free once the calling thread has
+/// seen it, otherwise it takes a shared lock, or an exclusive one to add a name that isn't in the table yet.
+///
+/// A default-constructed symbol is the empty name, with id 0.
+///
+/// @fn PLCL::Symbol::Symbol(std::string_view name)
+/// @brief Interns a name, adding it to the table if it isn't there yet.
+/// @param name The name.
+///
+/// @fn std::optional<PLCL::Symbol> PLCL::Symbol::find(std::string_view name)
+/// @brief Looks a name up without adding it, e.g. to search a tree for a name given by the user.
+/// @param name The name.
+/// @return The symbol, or nothing if the name was never interned, in which case no node can have it.
+///
+/// @fn uint32_t PLCL::Symbol::id() const
+/// @brief Returns the id of the symbol, ids are dense and start at 0.
+///
+/// @fn std::string_view PLCL::Symbol::view() const
+/// @brief Returns the name, it's valid until the end of the process.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+namespace PLCL {
+    class Symbol {
+    public:
+        Symbol();
+        explicit Symbol(std::string_view name);
+
+        [[nodiscard]] static std::optional<Symbol> find(std::string_view name);
+
+        [[nodiscard]] uint32_t id() const {
+            return this->entry->id;
+        }
+
+        [[nodiscard]] std::string_view view() const {
+            return this->entry->name;
+        }
+
+        operator std::string_view() const {
+            return this->entry->name;
+        }
+
+        [[nodiscard]] const char* data() const {
+            return this->entry->name.data();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return this->entry->name.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return this->entry->name.empty();
+        }
+
+        friend bool operator==(Symbol lhs, Symbol rhs) {
+            return lhs.entry == rhs.entry;
+        }
+
+        friend bool operator==(Symbol lhs, std::string_view rhs) {
+            return lhs.entry->name == rhs;
+        }
+
+        friend std::ostream& operator<<(std::ostream& stream, Symbol symbol) {
+            return stream << symbol.entry->name;
+        }
+
+    private:
+        struct Entry {
+            std::string_view name;
+            uint32_t id;
+        };
+
+        struct Table;
+
+        static const Entry emptyEntry;
+
+        const Entry* entry;
+
+        explicit Symbol(const Entry* entry) : entry(entry) {}
+
+        static const Entry* intern(std::string_view name, bool add);
+    };
+}
+
+template <>
+struct std::hash<PLCL::Symbol> {
+    size_t operator()(PLCL::Symbol symbol) const noexcept {
+        return symbol.id();
+    }
+};
+
+template <>
+struct std::formatter<PLCL::Symbol> : std::formatter<std::string_view> {
+    auto format(PLCL::Symbol symbol, std::format_context& context) const {
+        return std::formatter<std::string_view>::format(symbol.view(), context);
+    }
+};
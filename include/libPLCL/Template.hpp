@@ -21,30 +21,61 @@
 /// @struct PLCL::Template::TemplateRoot
 /// @brief A struct that represents the root of a template tree.
 ///
-/// @var std::string PLCL::Template::TemplateRoot::name 
+/// @var std::shared_ptr<PLCL::Generic::Arena> PLCL::Template::TemplateRoot::arena
+/// @brief The arena every node of a parsed tree, and every string those nodes own, is allocated from.
+/// @details It's shared between copies of the root, the whole tree is freed at once when the last copy is destroyed.
+/// It's null for trees built by hand.
+///
+/// @var std::pmr::string PLCL::Template::TemplateRoot::name 
 /// @brief The name of the template.
 ///
-/// @var std::vector<PLCL::Template::TemplateElement*> PLCL::Template::TemplateRoot::elements
+/// @var std::pmr::vector<PLCL::Template::TemplateElement*> PLCL::Template::TemplateRoot::elements
 /// @brief The list of elements in the top level of the template.
 ///
-/// @var std::vector<PLCL::Template::TemplateList*> PLCL::Template::TemplateRoot::lists
+/// @var std::pmr::vector<PLCL::Template::TemplateList*> PLCL::Template::TemplateRoot::lists
 /// @brief The list of lists in the top level of the template.
 ///
 /// @fn PLCL::Template::TemplateRoot::TemplateRoot()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateRoot::TemplateRoot(std::vector<Lexer::Token>& tokens)
-/// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
+/// @fn PLCL::Template::TemplateRoot::TemplateRoot(Lexer::TokenStream& tokens)
+/// @brief Constructor that parses tokens from the lexer into a new arena.
+/// @param tokens The stream of tokens to parse.
 ///
-/// @fn PLCL::Template::TemplateRoot::TemplateRoot(std::string name, std::vector<TemplateElement*> elements, std::vector<TemplateList*> lists)
+/// @fn PLCL::Template::TemplateRoot::TemplateRoot(Lexer::TokenStream& tokens, std::shared_ptr<Generic::Arena> arena)
+/// @brief Constructor that parses tokens from the lexer into the given arena.
+/// @param tokens The stream of tokens to parse.
+/// @param arena The arena to allocate the tree from.
+///
+/// @fn PLCL::Template::TemplateRoot::TemplateRoot(std::pmr::string name, std::pmr::vector<TemplateElement*> elements, std::pmr::vector<TemplateList*> lists)
 /// @brief Constructor that initializes all fields.
 ///
-/// @fn PLCL::Template::TemplateRoot PLCL::Template::TemplateRoot::fromString(const std::string& input)
+/// @fn PLCL::Template::TemplateRoot PLCL::Template::TemplateRoot::fromString(std::string_view input)
 /// @brief Parses a template from a string. 
 /// @param input The string to parse.
 /// @return The parsed template.
 ///
+/// @fn PLCL::Template::TemplateRoot PLCL::Template::TemplateRoot::fromFile(const std::filesystem::path& path)
+/// @brief Parses a template from a file.
+/// @details The file is lexed in place, see `SourceFile`. It isn't needed once this returns.
+/// @param path The path of the file to parse.
+/// @return The parsed template.
+///
+/// @fn PLCL::Template::TemplateRoot PLCL::Template::TemplateRoot::fromBinary(std::string_view data)
+/// @brief Decodes a template produced by `toBinary()`, without lexing or parsing anything.
+/// @param data The encoded template, it isn't needed once this returns.
+/// @return The decoded template.
+/// @throws std::runtime_error If the data isn't a template in the current binary format.
+///
+/// @fn PLCL::Template::TemplateRoot PLCL::Template::TemplateRoot::fromBinaryFile(const std::filesystem::path& path)
+/// @brief Decodes a template from a file, large files are mapped rather than read.
+/// @param path The path of the file.
+/// @return The decoded template.
+///
+/// @fn std::string PLCL::Template::TemplateRoot::toBinary() const
+/// @brief Encodes the template in the binary format described in `Binary.hpp`.
+/// @return The encoded template.
+///
 /// @fn std::string PLCL::Template::TemplateRoot::toString(size_t indent)
 /// @brief Converts the template to a string.
 /// @param indent The number of spaces to indent the template's contents.
@@ -54,25 +85,25 @@
 /// @brief A struct that represents a list in the template tree.
 /// @details It's used to store a list of elements in the template.
 ///
-/// @var std::string PLCL::Template::TemplateList::type
+/// @var PLCL::Symbol PLCL::Template::TemplateList::type
 /// @brief The type (name) of the list.
 ///
 /// @var PLCL::Template::TemplateOptions* PLCL::Template::TemplateList::options
 /// @brief The options of the list.
 ///
-/// @var std::vector<PLCL::Template::TemplateListElement*> PLCL::Template::TemplateList::elements
+/// @var std::pmr::vector<PLCL::Template::TemplateListElement*> PLCL::Template::TemplateList::elements
 /// @brief The list of elements in the list.
 ///
 /// @fn PLCL::Template::TemplateList::TemplateList()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateList::TemplateList(std::vector<Lexer::Token>& tokens, size_t& index)
+/// @fn PLCL::Template::TemplateList::TemplateList(Lexer::TokenStream& tokens, Generic::Allocator alloc)
 /// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the current token.
+/// @param tokens The stream of tokens to parse, positioned at the first token of the node.
+/// @param alloc The allocator for this node's strings and children.
 /// @attention This function is for internal use only.
 ///
-/// @fn PLCL::Template::TemplateList::TemplateList(std::string type, TemplateOptions* options, std::vector<TemplateListElement*> elements)
+/// @fn PLCL::Template::TemplateList::TemplateList(Symbol type, TemplateOptions* options, std::pmr::vector<TemplateListElement*> elements)
 /// @brief Constructor that initializes all fields.
 /// @param type The type (name) of the list.
 /// @param options The options of the list.
@@ -97,10 +128,10 @@
 /// @fn PLCL::Template::TemplateListElement::TemplateListElement()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateListElement::TemplateListElement(std::vector<Lexer::Token>& tokens, size_t& index)
+/// @fn PLCL::Template::TemplateListElement::TemplateListElement(Lexer::TokenStream& tokens, Generic::Allocator alloc)
 /// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the current token.
+/// @param tokens The stream of tokens to parse, positioned at the first token of the node.
+/// @param alloc The allocator for this node's strings and children.
 /// @attention This function is for internal use only.
 ///
 /// @fn PLCL::Template::TemplateListElement::TemplateListElement(size_t id, TemplateElement* element)
@@ -117,28 +148,28 @@
 /// @struct PLCL::Template::TemplateElement
 /// @brief A struct that represents an element in the template tree.
 /// 
-/// @var std::string PLCL::Template::TemplateElement::type 
+/// @var PLCL::Symbol PLCL::Template::TemplateElement::type 
 /// @brief The type (name) of the element.
 ///
 /// @var PLCL::Template::TemplateOptions* PLCL::Template::TemplateElement::options 
 /// @brief The options of the element.
 ///
-/// @var std::vector<PLCL::Template::TemplateAttribute*> PLCL::Template::TemplateElement::attributes 
+/// @var std::pmr::vector<PLCL::Template::TemplateAttribute*> PLCL::Template::TemplateElement::attributes 
 /// @brief The list of attributes of the element.
 ///
-/// @var std::vector<PLCL::Template::TemplateList*> PLCL::Template::TemplateElement::lists
+/// @var std::pmr::vector<PLCL::Template::TemplateList*> PLCL::Template::TemplateElement::lists
 /// @brief The list of lists in the element.
 ///
 /// @fn PLCL::Template::TemplateElement::TemplateElement()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateElement::TemplateElement(std::vector<Lexer::Token>& tokens, size_t& index)
+/// @fn PLCL::Template::TemplateElement::TemplateElement(Lexer::TokenStream& tokens, Generic::Allocator alloc)
 /// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the current token.
+/// @param tokens The stream of tokens to parse, positioned at the first token of the node.
+/// @param alloc The allocator for this node's strings and children.
 /// @attention This function is for internal use only.
 ///
-/// @fn PLCL::Template::TemplateElement::TemplateElement(std::string type, TemplateOptions* options, std::vector<TemplateAttribute*> attributes, std::vector<TemplateList*> lists)
+/// @fn PLCL::Template::TemplateElement::TemplateElement(Symbol type, TemplateOptions* options, std::pmr::vector<TemplateAttribute*> attributes, std::pmr::vector<TemplateList*> lists)
 /// @brief Constructor that initializes all fields.
 /// @param type The type (name) of the element.
 /// @param options The options of the element.
@@ -154,19 +185,19 @@
 /// @struct PLCL::Template::TemplateOptions
 /// @brief A struct that represents the options of a template element or list.
 /// 
-/// @var std::vector<PLCL::Template::TemplateOption*> PLCL::Template::TemplateOptions::options
+/// @var std::pmr::vector<PLCL::Template::TemplateOption*> PLCL::Template::TemplateOptions::options
 /// @brief The list of options.
 ///
 /// @fn PLCL::Template::TemplateOptions::TemplateOptions()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateOptions::TemplateOptions(std::vector<Lexer::Token>& tokens, size_t& index)
+/// @fn PLCL::Template::TemplateOptions::TemplateOptions(Lexer::TokenStream& tokens, Generic::Allocator alloc)
 /// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the current token.
+/// @param tokens The stream of tokens to parse, positioned at the first token of the node.
+/// @param alloc The allocator for this node's strings and children.
 /// @attention This function is for internal use only.
 ///
-/// @fn PLCL::Template::TemplateOptions::TemplateOptions(std::vector<TemplateOption*> options)
+/// @fn PLCL::Template::TemplateOptions::TemplateOptions(std::pmr::vector<TemplateOption*> options)
 /// @brief Constructor that initializes all fields.
 /// @param options The list of options.
 ///
@@ -180,22 +211,22 @@
 /// @struct PLCL::Template::TemplateOption
 /// @brief A struct that represents an option of a template element or list.
 ///
-/// @var std::string PLCL::Template::TemplateOption::name 
+/// @var std::pmr::string PLCL::Template::TemplateOption::name 
 /// @brief The name of the option.
 ///
-/// @var Generic::ValueType PLCL::Template::TemplateOption::value 
+/// @var Generic::Value PLCL::Template::TemplateOption::value 
 /// @brief The value of the option.
 ///
 /// @fn PLCL::Template::TemplateOption::TemplateOption()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateOption::TemplateOption(std::vector<Lexer::Token>& tokens, size_t& index)
+/// @fn PLCL::Template::TemplateOption::TemplateOption(Lexer::TokenStream& tokens, Generic::Allocator alloc)
 /// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the current token.
+/// @param tokens The stream of tokens to parse, positioned at the first token of the node.
+/// @param alloc The allocator for this node's strings and children.
 /// @attention This function is for internal use only.
 ///
-/// @fn PLCL::Template::TemplateOption::TemplateOption(std::string name, Generic::ValueType value)
+/// @fn PLCL::Template::TemplateOption::TemplateOption(std::pmr::string name, Generic::Value value)
 /// @brief Constructor that initializes all fields.
 /// @param name The name of the option.
 /// @param value The value of the option.
@@ -211,12 +242,12 @@
 /// @var PLCL::Template::AttributeType PLCL::Template::TemplateAttribute::type
 /// @brief The type of the attribute.
 ///
-/// @var std::string PLCL::Template::TemplateAttribute::name
+/// @var PLCL::Symbol PLCL::Template::TemplateAttribute::name
 /// @brief The name of the attribute.
 ///
-/// @var std::string* PLCL::Template::TemplateAttribute::defaultValue 
+/// @var std::optional<std::pmr::string> PLCL::Template::TemplateAttribute::defaultValue 
 /// @brief The default value of the attribute.
-/// @details This is a pointer to allow for a null value.
+/// @details Empty if the attribute has no default value.
 ///
 /// @var bool PLCL::Template::TemplateAttribute::required
 /// @brief Whether the attribute is required.
@@ -225,13 +256,13 @@
 /// @fn PLCL::Template::TemplateAttribute::TemplateAttribute()
 /// @brief Default constructor.
 ///
-/// @fn PLCL::Template::TemplateAttribute::TemplateAttribute(std::vector<Lexer::Token>& tokens, size_t& index)
+/// @fn PLCL::Template::TemplateAttribute::TemplateAttribute(Lexer::TokenStream& tokens, Generic::Allocator alloc)
 /// @brief Constructor that parses tokens from the lexer.
-/// @param tokens The list of tokens to parse.
-/// @param index The index of the current token.
+/// @param tokens The stream of tokens to parse, positioned at the first token of the node.
+/// @param alloc The allocator for this node's strings and children.
 /// @attention This function is for internal use only.
 ///
-/// @fn PLCL::Template::TemplateAttribute::TemplateAttribute(AttributeType type, std::string name, std::string* defaultValue, bool required)
+/// @fn PLCL::Template::TemplateAttribute::TemplateAttribute(AttributeType type, Symbol name, std::optional<std::pmr::string> defaultValue, bool required)
 /// @brief Constructor that initializes all fields.
 /// @param type The type of the attribute.
 /// @param name The name of the attribute.
@@ -244,11 +275,17 @@
 /// @return The attribute as a string.
 
 #pragma once
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Generic.hpp"
 #include "Lexer.hpp"
+#include "Symbol.hpp"
+#include "Value.hpp"
 
 namespace PLCL::Template {
     enum class AttributeType {
@@ -274,28 +311,34 @@ namespace PLCL::Template {
     struct TemplateAttribute;
 
     struct TemplateRoot {
-        std::string name;
-        std::vector<TemplateElement*> elements;
-        std::vector<TemplateList*> lists;
+        std::shared_ptr<Generic::Arena> arena;
+        std::pmr::string name;
+        std::pmr::vector<TemplateElement*> elements;
+        std::pmr::vector<TemplateList*> lists;
 
         TemplateRoot() = default;
-        explicit TemplateRoot(std::vector<Lexer::Token>& tokens);
-        TemplateRoot(std::string name, std::vector<TemplateElement*> elements, std::vector<TemplateList*> lists)
+        explicit TemplateRoot(Lexer::TokenStream& tokens);
+        TemplateRoot(Lexer::TokenStream& tokens, std::shared_ptr<Generic::Arena> arena);
+        TemplateRoot(std::pmr::string name, std::pmr::vector<TemplateElement*> elements, std::pmr::vector<TemplateList*> lists)
             : name(std::move(name)), elements(std::move(elements)), lists(std::move(lists)) {};
 
-        [[maybe_unused]] static TemplateRoot fromString(const std::string& input);
+        [[maybe_unused]] static TemplateRoot fromString(std::string_view input);
+        [[maybe_unused]] static TemplateRoot fromFile(const std::filesystem::path& path);
+        [[maybe_unused]] static TemplateRoot fromBinary(std::string_view data);
+        [[maybe_unused]] static TemplateRoot fromBinaryFile(const std::filesystem::path& path);
+        [[maybe_unused]] std::string toBinary() const;
         [[maybe_unused]] std::string toString(size_t indent);
     };
 
     struct TemplateList {
-        std::string type;
+        Symbol type;
         TemplateOptions* options = nullptr;
-        std::vector<TemplateListElement*> elements;
+        std::pmr::vector<TemplateListElement*> elements;
 
         TemplateList() = default;
-        TemplateList(std::vector<Lexer::Token>& tokens, size_t& index);
-        TemplateList(std::string type, TemplateOptions* options, std::vector<TemplateListElement*> elements)
-            : type(std::move(type)), options(options), elements(std::move(elements)) {};
+        TemplateList(Lexer::TokenStream& tokens, Generic::Allocator alloc = {});
+        TemplateList(Symbol type, TemplateOptions* options, std::pmr::vector<TemplateListElement*> elements)
+            : type(type), options(options), elements(std::move(elements)) {};
 
         [[maybe_unused]] std::string toString(size_t indent, size_t indentStart);
     };
@@ -305,7 +348,7 @@ namespace PLCL::Template {
         TemplateElement* element = nullptr; 
 
         TemplateListElement() = default;
-        TemplateListElement(std::vector<Lexer::Token>& tokens, size_t& index);
+        TemplateListElement(Lexer::TokenStream& tokens, Generic::Allocator alloc = {});
         TemplateListElement(size_t id, TemplateElement* element)
             : id(id), element(element) {};
 
@@ -313,37 +356,37 @@ namespace PLCL::Template {
     };
 
     struct TemplateElement {
-        std::string type;
+        Symbol type;
         TemplateOptions* options = nullptr;
-        std::vector<TemplateAttribute*> attributes;
-        std::vector<TemplateList*> lists;
+        std::pmr::vector<TemplateAttribute*> attributes;
+        std::pmr::vector<TemplateList*> lists;
 
         TemplateElement() = default;
-        TemplateElement(std::vector<Lexer::Token>& tokens, size_t& index);
-        TemplateElement(std::string type, TemplateOptions* options, std::vector<TemplateAttribute*> attributes, std::vector<TemplateList*> lists)
-            : type(std::move(type)), options(options), attributes(std::move(attributes)), lists(std::move(lists)) {};
+        TemplateElement(Lexer::TokenStream& tokens, Generic::Allocator alloc = {});
+        TemplateElement(Symbol type, TemplateOptions* options, std::pmr::vector<TemplateAttribute*> attributes, std::pmr::vector<TemplateList*> lists)
+            : type(type), options(options), attributes(std::move(attributes)), lists(std::move(lists)) {};
 
         [[maybe_unused]] std::string toString(size_t indent, size_t indentStart);
     };
 
     struct TemplateOptions {
-        std::vector<TemplateOption*> options;
+        std::pmr::vector<TemplateOption*> options;
 
         TemplateOptions() = default;
-        TemplateOptions(std::vector<Lexer::Token>& tokens, size_t& index);
-        explicit TemplateOptions(std::vector<TemplateOption*> options)
+        TemplateOptions(Lexer::TokenStream& tokens, Generic::Allocator alloc = {});
+        explicit TemplateOptions(std::pmr::vector<TemplateOption*> options)
             : options(std::move(options)) {};
 
         [[maybe_unused]] std::string toString(size_t indent, size_t indentStart, OptionsType optionsType);
     };
 
     struct TemplateOption {
-        std::string name;
-        Generic::ValueType value;
+        std::pmr::string name;
+        Generic::Value value;
 
         TemplateOption() = default;
-        TemplateOption(std::vector<Lexer::Token>& tokens, size_t& index);
-        TemplateOption(std::string name, Generic::ValueType value)
+        TemplateOption(Lexer::TokenStream& tokens, Generic::Allocator alloc = {});
+        TemplateOption(std::pmr::string name, Generic::Value value)
             : name(std::move(name)), value(std::move(value)) {};
 
         [[maybe_unused]] std::string toString(size_t indent);
@@ -351,14 +394,14 @@ namespace PLCL::Template {
 
     struct TemplateAttribute {
         AttributeType type;
-        std::string name;
-        std::string* defaultValue = nullptr;
+        Symbol name;
+        std::optional<std::pmr::string> defaultValue;
         bool required = false;
 
         TemplateAttribute() = default;
-        TemplateAttribute(std::vector<Lexer::Token>& tokens, size_t& index);
-        TemplateAttribute(AttributeType type, std::string name, std::string* defaultValue, bool required)
-            : type(type), name(std::move(name)), defaultValue(defaultValue), required(required) {};
+        TemplateAttribute(Lexer::TokenStream& tokens, Generic::Allocator alloc = {});
+        TemplateAttribute(AttributeType type, Symbol name, std::optional<std::pmr::string> defaultValue, bool required)
+            : type(type), name(name), defaultValue(std::move(defaultValue)), required(required) {};
 
         [[maybe_unused]] std::string toString(size_t indent);
     };
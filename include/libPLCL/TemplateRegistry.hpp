@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Sharing templates between the parts of a process.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::TemplateRegistry
+/// @brief Templates by name, each parsed and compiled once and shared by everyone who validates against it.
+/// @details A registered template is frozen: it's only handed out as a pointer to a const `Entry`, next to the
+/// `Validator` compiled from it, and stays alive for as long as anyone holds it, even after the registry is gone.
+///
+/// The registry is published as an immutable snapshot, like `ConfigHandle` publishes configurations. Lookups load the
+/// current snapshot and search it, they never wait for anything. Registering copies the snapshot, adds the template
+/// and swaps the copy in, registrations are serialized among themselves only.
+///
+/// @struct PLCL::Config::TemplateRegistry::Entry
+/// @brief A registered template and its compiled form.
+/// @details The nodes of the template must not be changed through its pointers.
+///
+/// @fn PLCL::Config::TemplateRegistry::Entry::Entry(Template::TemplateRoot configTemplate)
+/// @brief Compiles a template.
+/// @throws std::runtime_error If the template can't be compiled, see `Validator`.
+///
+/// @fn std::shared_ptr<const PLCL::Config::TemplateRegistry::Entry> PLCL::Config::TemplateRegistry::add(Template::TemplateRoot configTemplate)
+/// @brief Compiles a template and registers it under its name.
+/// @param configTemplate The template to register.
+/// @return The registered template.
+/// @throws std::runtime_error If another template already has this name, or the template can't be compiled.
+///
+/// @fn std::shared_ptr<const PLCL::Config::TemplateRegistry::Entry> PLCL::Config::TemplateRegistry::load(const std::filesystem::path& path)
+/// @brief Registers the template in a file, unless it's already registered.
+/// @details Files are told apart by their canonical path. However many threads load the same file, it's parsed once.
+/// @param path The path of the template.
+/// @return The template of the file.
+/// @throws std::runtime_error If the file can't be read or parsed, or another template already has its name.
+///
+/// @fn std::shared_ptr<const PLCL::Config::TemplateRegistry::Entry> PLCL::Config::TemplateRegistry::find(std::string_view name) const
+/// @brief Looks up a template.
+/// @param name The name of the template.
+/// @return The template, or null if there's none with that name.
+///
+/// @fn std::shared_ptr<const PLCL::Config::Validator> PLCL::Config::TemplateRegistry::validator(std::string_view name) const
+/// @brief Looks up the validator of a template, sharing ownership of the whole entry, e.g. for `ConfigHandle`.
+/// @param name The name of the template.
+/// @return The validator of the template.
+/// @throws std::runtime_error If there's no template with that name.
+///
+/// @fn void PLCL::Config::TemplateRegistry::verify(const ConfigRoot& config, std::string_view name, bool strict, bool parallel) const
+/// @brief Verifies a configuration against a registered template, like `ConfigRoot::verify()` without compiling it.
+/// @param config The configuration to verify.
+/// @param name The name of the template.
+/// @param strict Whether to report elements, lists and attributes that aren't in the template.
+/// @param parallel Whether to check independent parts of the configuration on several threads.
+/// @throws std::runtime_error If there's no template with that name, or listing every problem found.
+
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include "Config.hpp"
+#include "Generic.hpp"
+#include "Template.hpp"
+#include "Validator.hpp"
+
+namespace PLCL::Config {
+    class TemplateRegistry {
+    public:
+        struct Entry {
+            Template::TemplateRoot configTemplate;
+            Validator validator;
+
+            explicit Entry(Template::TemplateRoot configTemplate)
+                : configTemplate(std::move(configTemplate)), validator(this->configTemplate) {}
+        };
+
+        TemplateRegistry() = default;
+        TemplateRegistry(const TemplateRegistry&) = delete;
+        TemplateRegistry& operator=(const TemplateRegistry&) = delete;
+
+        std::shared_ptr<const Entry> add(Template::TemplateRoot configTemplate);
+        std::shared_ptr<const Entry> load(const std::filesystem::path& path);
+        [[nodiscard]] std::shared_ptr<const Entry> find(std::string_view name) const;
+        [[nodiscard]] std::shared_ptr<const Validator> validator(std::string_view name) const;
+        void verify(const ConfigRoot& config, std::string_view name, bool strict, bool parallel = false) const;
+
+    private:
+        struct Snapshot {
+            Generic::StringTable<std::shared_ptr<const Entry>> names;
+            std::map<std::filesystem::path, std::shared_ptr<const Entry>> files;
+        };
+
+        std::atomic<std::shared_ptr<const Snapshot>> current{std::make_shared<const Snapshot>()};
+        std::mutex addMutex;
+
+        std::shared_ptr<const Entry> publish(std::shared_ptr<const Entry> entry, const std::filesystem::path* path);
+    };
+}
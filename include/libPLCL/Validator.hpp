@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief Checking configurations against templates.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Config::Validator
+/// @brief A template compiled into lookup tables, so configurations can be checked against it in linear time.
+/// @details Compiling walks the template once. Every element type gets a hash table from attribute names to their
+/// types and a bitmask of its required attributes, every list gets its `minimumCount` and `maximumCount`, and every
+/// level of the tree gets a table of the element and list types allowed there.
+/// A validator is immutable once constructed, so it can be reused for any number of configurations, from any number
+/// of threads.
+///
+/// Elements in a configuration list are matched with the elements of the template list by type, ids aren't compared.
+/// Integers are accepted for float attributes. Elements, lists and attributes the template doesn't know about are
+/// skipped, unless the validation is strict, in which case they're reported.
+///
+/// The options understood are `required` (elements and lists) and `minimumCount` and `maximumCount` (lists),
+/// others are ignored.
+///
+/// @fn PLCL::Config::Validator::Validator(const Template::TemplateRoot& configTemplate)
+/// @brief Compiles a template.
+/// @param configTemplate The template to compile, it isn't needed once this returns.
+/// @throws std::runtime_error If the template is ambiguous or an option has a value of the wrong type.
+///
+/// @fn std::vector<std::string> PLCL::Config::Validator::validate(const ConfigRoot& config, bool strict, bool parallel) const
+/// @brief Checks a configuration against the template.
+/// @details In parallel mode the top-level elements and lists are checked on a pool of threads, and so are chunks of
+/// the elements of large top-level lists. The result is the same as in serial mode, in the same order.
+/// @param config The configuration to check.
+/// @param strict Whether to report elements, lists and attributes that aren't in the template.
+/// @param parallel Whether to use all the available cores.
+/// @return Every problem found, empty if the configuration is valid. They're in the order of the nodes they're about
+/// in the source, except that the attributes of an element are checked before its lists, and that missing required
+/// nodes and attributes are reported at the end of the node that should contain them. The top level is only in source
+/// order if `ConfigRoot::listPositions` is known, otherwise its lists are checked after its elements.
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Config.hpp"
+#include "Generic.hpp"
+#include "Symbol.hpp"
+#include "Template.hpp"
+
+namespace PLCL::Config {
+    class Validator {
+    public:
+        explicit Validator(const Template::TemplateRoot& configTemplate);
+
+        [[nodiscard]] std::vector<std::string> validate(const ConfigRoot& config, bool strict, bool parallel = false) const;
+
+    private:
+        class Compiler;
+        class Checker;
+        struct Task;
+
+        static constexpr uint32_t optional = UINT32_MAX;
+        static constexpr size_t chunkSize = 4096;
+
+        // Keyed by interned names, so a lookup hashes an id and compares pointers.
+        template <typename T>
+        using Table = std::unordered_map<Symbol, T>;
+
+        // `bit` numbers the required entries of a scope, it's `optional` for the others.
+        struct Entry {
+            uint32_t index;
+            uint32_t bit;
+        };
+
+        // The element and list types allowed at one level of the tree. `required` describes what's missing when a
+        // required entry isn't found, by bit.
+        struct Scope {
+            Table<Entry> elements;
+            Table<Entry> lists;
+            std::vector<std::string> required;
+        };
+
+        // Every attribute has a bit, so duplicates can be found with the same mask that tracks the required ones.
+        struct Attribute {
+            Template::AttributeType type;
+            uint32_t bit;
+        };
+
+        struct Element {
+            Table<Attribute> attributes;
+            std::vector<Symbol> attributeNames;
+            std::vector<uint64_t> required;
+            Scope lists;
+        };
+
+        struct List {
+            size_t minimumCount;
+            size_t maximumCount;
+            Scope elements;
+        };
+
+        Scope root;
+        std::vector<Element> elements;
+        std::vector<List> lists;
+
+        std::vector<std::string> validateParallel(const ConfigRoot& config, bool strict) const;
+    };
+}
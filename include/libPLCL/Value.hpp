@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// @brief The values of attributes and options.
+/// @attention This file is not meant to be included by the end user.
+///
+/// @class PLCL::Generic::Value
+/// @brief A string, an integer, a floating point number or a boolean, in 16 bytes.
+/// @details Numbers and booleans are held inline. A string is a pointer and a length into storage owned by the
+/// document the value belongs to, usually the arena of its tree, so a value never owns or frees anything and copying
+/// one is copying 16 bytes. `copy()` puts a string in such storage, the constructor taking a `std::string_view` only
+/// refers to it.
+///
+/// Values are read like `std::variant`s, with the `holds_alternative()`, `get()`, `get_if()` and `visit()` functions
+/// of this namespace, which argument-dependent lookup finds unqualified. The string alternative is `std::string_view`.
+/// `get_if()` returns a `std::optional` instead of a pointer, since there's no `std::string_view` to point to.
+///
+/// @fn PLCL::Generic::Value::Value()
+/// @brief Constructs an empty string, like a default-constructed variant.
+///
+/// @fn PLCL::Generic::Value::Value(std::string_view string)
+/// @brief Constructs a string referring to `string`, which must outlive the value.
+/// @throws std::runtime_error If the string is 4 GiB or longer.
+///
+/// @fn PLCL::Generic::Value::Value(T integer)
+/// @brief Constructs an integer from any other integer type, so `Value value = 5;` holds an `int64_t`.
+/// @throws std::runtime_error If the integer doesn't fit in an `int64_t`.
+///
+/// @fn PLCL::Generic::Value PLCL::Generic::Value::copy(std::string_view string, Allocator alloc)
+/// @brief Copies a string into memory from `alloc`, which is never given back, and constructs a value referring to it.
+/// @param string The string to copy.
+/// @param alloc The allocator of the document's storage, e.g. of its arena.
+/// @return The string value.
+///
+/// @fn size_t PLCL::Generic::Value::index() const
+/// @brief Returns the alternative held: 0 for strings, 1 for integers, 2 for floats and 3 for booleans, the order of
+/// the former `std::variant`.
+///
+/// @fn bool PLCL::Generic::holds_alternative(const Value& value)
+/// @brief Returns whether a value holds a `T`.
+/// @tparam T `std::string_view`, `int64_t`, `float64_t` or `bool`.
+///
+/// @fn T PLCL::Generic::get(const Value& value)
+/// @brief Returns the `T` a value holds.
+/// @throws std::bad_variant_access If it holds something else.
+///
+/// @fn std::optional<T> PLCL::Generic::get_if(const Value* value)
+/// @brief Returns the `T` a value holds, or nothing if the value is null or holds something else.
+///
+/// @fn decltype(auto) PLCL::Generic::visit(Visitor&& visitor, const Value& value)
+/// @brief Calls `visitor` with what a value holds, as a `std::string_view`, `int64_t`, `float64_t` or `bool`.
+///
+/// @typedef PLCL::Generic::ValueType
+/// @brief The former name of `Value`.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include "Generic.hpp"
+
+namespace PLCL::Generic {
+    class Value {
+    public:
+        Value() : Value(std::string_view()) {}
+
+        explicit Value(std::string_view string) : string(string.data()), length(lengthOf(string)), tag(Tag::String) {}
+
+        // Would silently become a boolean.
+        Value(const char*) = delete;
+
+        Value(int64_t integer) : integer(integer), tag(Tag::Integer) {}
+
+        // Any other integer would be ambiguous between the integer, the float and the boolean.
+        template <typename T>
+            requires(std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, int64_t>)
+        Value(T integer) : Value(integerOf(integer)) {}
+
+        Value(float64_t float64) : float64(float64), tag(Tag::Float) {}
+        Value(bool boolean) : boolean(boolean), tag(Tag::Boolean) {}
+
+        static Value copy(std::string_view string, Allocator alloc) {
+            if (string.empty()) {
+                return Value();
+            }
+            auto* data = static_cast<char*>(alloc.allocate_bytes(string.size(), 1));
+            string.copy(data, string.size());
+            return Value(std::string_view(data, string.size()));
+        }
+
+        [[nodiscard]] size_t index() const {
+            return static_cast<size_t>(this->tag);
+        }
+
+        friend bool operator==(const Value& lhs, const Value& rhs) {
+            if (lhs.tag != rhs.tag) {
+                return false;
+            }
+            switch (lhs.tag) {
+                case Tag::String:
+                    return lhs.view() == rhs.view();
+                case Tag::Integer:
+                    return lhs.integer == rhs.integer;
+                case Tag::Float:
+                    return lhs.float64 == rhs.float64;
+                case Tag::Boolean:
+                    return lhs.boolean == rhs.boolean;
+                [[unlikely]] default:
+                    std::unreachable();
+            }
+        }
+
+        template <typename T>
+        friend bool holds_alternative(const Value& value) noexcept;
+
+        template <typename T>
+        friend std::optional<T> get_if(const Value* value) noexcept;
+
+        template <typename Visitor>
+        friend decltype(auto) visit(Visitor&& visitor, const Value& value);
+
+    private:
+        enum class Tag : uint8_t {
+            String,
+            Integer,
+            Float,
+            Boolean
+        };
+
+        union {
+            const char* string;
+            int64_t integer;
+            float64_t float64;
+            bool boolean;
+        };
+        uint32_t length = 0;
+        Tag tag;
+
+        static uint32_t lengthOf(std::string_view string) {
+            if (string.size() > UINT32_MAX) {
+                throw std::runtime_error(std::format("String value of {} bytes is too long", string.size()));
+            }
+            return static_cast<uint32_t>(string.size());
+        }
+
+        template <typename T>
+        static int64_t integerOf(T integer) {
+            if constexpr (std::is_unsigned_v<T> && sizeof(T) >= sizeof(int64_t)) {
+                if (integer > static_cast<T>(INT64_MAX)) {
+                    throw std::runtime_error(std::format("Integer value {} is too large", integer));
+                }
+            }
+            return static_cast<int64_t>(integer);
+        }
+
+        [[nodiscard]] std::string_view view() const {
+            return {this->string, this->length};
+        }
+
+        template <typename T>
+        static constexpr Tag tagOf() {
+            static_assert(std::is_same_v<T, std::string_view> || std::is_same_v<T, int64_t> || std::is_same_v<T, float64_t> || std::is_same_v<T, bool>,
+                          "A value holds std::string_view, int64_t, float64_t or bool");
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                return Tag::String;
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                return Tag::Integer;
+            } else if constexpr (std::is_same_v<T, float64_t>) {
+                return Tag::Float;
+            } else {
+                return Tag::Boolean;
+            }
+        }
+
+        template <typename T>
+        [[nodiscard]] T as() const {
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                return this->view();
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                return this->integer;
+            } else if constexpr (std::is_same_v<T, float64_t>) {
+                return this->float64;
+            } else {
+                return this->boolean;
+            }
+        }
+    };
+
+    static_assert(sizeof(Value) == 16);
+
+    template <typename T>
+    bool holds_alternative(const Value& value) noexcept {
+        return value.tag == Value::tagOf<T>();
+    }
+
+    template <typename T>
+    std::optional<T> get_if(const Value* value) noexcept {
+        if (value == nullptr || !holds_alternative<T>(*value)) {
+            return std::nullopt;
+        }
+        return value->as<T>();
+    }
+
+    template <typename T>
+    T get(const Value& value) {
+        std::optional<T> result = get_if<T>(&value);
+        if (!result) {
+            throw std::bad_variant_access();
+        }
+        return *result;
+    }
+
+    template <typename Visitor>
+    decltype(auto) visit(Visitor&& visitor, const Value& value) {
+        switch (value.tag) {
+            case Value::Tag::String:
+                return std::forward<Visitor>(visitor)(value.view());
+            case Value::Tag::Integer:
+                return std::forward<Visitor>(visitor)(value.integer);
+            case Value::Tag::Float:
+                return std::forward<Visitor>(visitor)(value.float64);
+            case Value::Tag::Boolean:
+                return std::forward<Visitor>(visitor)(value.boolean);
+            [[unlikely]] default:
+                std::unreachable();
+        }
+    }
+
+    using ValueType = Value;
+}
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bit>
+#include <format>
+#include <stdexcept>
+#include <Binary.hpp>
+
+namespace PLCL::Binary {
+    namespace {
+        constexpr std::string_view magic = "PLCB";
+
+        enum class ValueTag : uint8_t {
+            String,
+            Integer,
+            Float,
+            False,
+            True,
+        };
+
+        std::runtime_error invalid(std::string_view what) {
+            return std::runtime_error(std::format("Invalid binary tree: {}", what));
+        }
+
+        void appendVarint(std::string &out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+    }
+
+    void Writer::byte(uint8_t value) {
+        this->body.push_back(static_cast<char>(value));
+    }
+
+    void Writer::varint(uint64_t value) {
+        appendVarint(this->body, value);
+    }
+
+    void Writer::integer(int64_t value) {
+        this->varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void Writer::float64(Generic::float64_t value) {
+        auto bits = std::bit_cast<uint64_t>(value);
+        for (size_t i = 0; i < 8; i++) {
+            this->byte(static_cast<uint8_t>(bits >> (i * 8)));
+        }
+    }
+
+    void Writer::string(std::string_view value) {
+        auto [id, added] = this->ids.try_emplace(value, this->strings.size());
+        if (added) {
+            this->strings.push_back(value);
+        }
+        this->varint(id->second);
+    }
+
+    void Writer::value(const Generic::Value &value) {
+        if (auto string = Generic::get_if<std::string_view>(&value)) {
+            this->byte(static_cast<uint8_t>(ValueTag::String));
+            this->string(*string);
+        } else if (auto integer = Generic::get_if<int64_t>(&value)) {
+            this->byte(static_cast<uint8_t>(ValueTag::Integer));
+            this->integer(*integer);
+        } else if (auto float64 = Generic::get_if<Generic::float64_t>(&value)) {
+            this->byte(static_cast<uint8_t>(ValueTag::Float));
+            this->float64(*float64);
+        } else {
+            this->byte(static_cast<uint8_t>(Generic::get<bool>(value) ? ValueTag::True : ValueTag::False));
+        }
+    }
+
+    std::string Writer::finish() const {
+        std::string result(magic);
+        appendVarint(result, version);
+        result.push_back(this->kind);
+        appendVarint(result, this->strings.size());
+        for (auto string : this->strings) {
+            appendVarint(result, string.size());
+            result += string;
+        }
+        result += this->body;
+        return result;
+    }
+
+    Reader::Reader(std::string_view data, char kind) : data(data) {
+        if (!data.starts_with(magic)) {
+            throw invalid("missing header");
+        }
+        this->index = magic.size();
+        uint64_t fileVersion = this->varint();
+        if (fileVersion != version) {
+            throw invalid(std::format("format version {}, expected {}", fileVersion, version));
+        }
+        char fileKind = static_cast<char>(this->byte());
+        if (fileKind != kind) {
+            throw invalid(std::format("tree of kind {}, expected {}", fileKind, kind));
+        }
+        size_t count = this->count();
+        this->strings.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            uint64_t size = this->varint();
+            if (size > this->data.size() - this->index) {
+                throw invalid("truncated string table");
+            }
+            this->strings.push_back(this->data.substr(this->index, size));
+            this->index += size;
+        }
+    }
+
+    uint8_t Reader::byte() {
+        if (this->index >= this->data.size()) {
+            throw invalid("unexpected end of input");
+        }
+        return static_cast<uint8_t>(this->data[this->index++]);
+    }
+
+    uint64_t Reader::varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = this->byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw invalid("varint longer than 64 bits");
+    }
+
+    int64_t Reader::integer() {
+        uint64_t value = this->varint();
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    Generic::float64_t Reader::float64() {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 8; i++) {
+            bits |= static_cast<uint64_t>(this->byte()) << (i * 8);
+        }
+        return std::bit_cast<Generic::float64_t>(bits);
+    }
+
+    std::string_view Reader::string() {
+        uint64_t id = this->varint();
+        if (id >= this->strings.size()) {
+            throw invalid(std::format("string {} out of range", id));
+        }
+        return this->strings[id];
+    }
+
+    Generic::Value Reader::value(Generic::Allocator alloc) {
+        switch (static_cast<ValueTag>(this->byte())) {
+            case ValueTag::String:
+                return Generic::Value::copy(this->string(), alloc);
+            case ValueTag::Integer:
+                return this->integer();
+            case ValueTag::Float:
+                return this->float64();
+            case ValueTag::False:
+                return false;
+            case ValueTag::True:
+                return true;
+            [[unlikely]] default:
+                throw invalid("unknown value tag");
+        }
+    }
+
+    size_t Reader::count() {
+        uint64_t count = this->varint();
+        if (count > this->data.size() - this->index) {
+            throw invalid(std::format("count {} larger than the rest of the input", count));
+        }
+        return count;
+    }
+
+    void Reader::finish() const {
+        if (this->index != this->data.size()) {
+            throw invalid("trailing bytes");
+        }
+    }
+}
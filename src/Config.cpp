@@ -3,250 +3,266 @@
 #include <cstdint>
 #include <stdexcept>
 #include <format>
+#include <memory>
+#include <vector>
+#include <Binary.hpp>
 #include <Config.hpp>
+#include <ConfigHandler.hpp>
+#include <Serializer.hpp>
+#include <Validator.hpp>
+#include <SourceFile.hpp>
 
 namespace PLCL::Config {
-    [[maybe_unused]] ConfigRoot ConfigRoot::fromString(const std::string &input) {
+    [[maybe_unused]] ConfigRoot ConfigRoot::fromString(std::string_view input) {
         Lexer lexer(input);
-        auto tokens = lexer.lex();
+        Lexer::TokenStream tokens(lexer);
         return ConfigRoot(tokens);
     }
 
-    ConfigRoot::ConfigRoot(std::vector<Lexer::Token> &tokens) {
-        size_t index = 0;
-        if (tokens[index].type != Lexer::TokenType::ConfigName) {
-            throw std::runtime_error(std::format(R"(Expected "ConfigName" at line {}, column {}, got {})", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-        }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw std::runtime_error(std::format("Expected Name at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+    [[maybe_unused]] ConfigRoot ConfigRoot::fromFile(const std::filesystem::path &path) {
+        SourceFile file(path);
+        Lexer lexer(file.view());
+        Lexer::TokenStream tokens(lexer);
+        return ConfigRoot(tokens);
+    }
+
+    namespace {
+        void encode(Binary::Writer &out, const ConfigList &list);
+
+        void encode(Binary::Writer &out, const ConfigElement &element) {
+            out.string(element.type);
+            out.varint(element.attributes.size());
+            for (const auto *attribute : element.attributes) {
+                out.string(attribute->name);
+                out.value(attribute->value);
+            }
+            out.varint(element.lists.size());
+            for (const auto *list : element.lists) {
+                encode(out, *list);
+            }
         }
-        this->name = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            switch (tokens[index].type) {
-                case Lexer::TokenType::Import:
-                    index++;
-                    if (tokens[index].type != Lexer::TokenType::StringLiteral) {
-                        throw std::runtime_error(std::format("Expected string at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-                    }
-                    this->imports.push_back(tokens[index].value);
-                    index++;
-                    break;
-                case Lexer::TokenType::ConfigElement:
-                    this->elements.push_back(new ConfigElement(tokens, index));
-                    break;
-                case Lexer::TokenType::ConfigList:
-                    this->lists.push_back(new ConfigList(tokens, index));
-                    break;
-                case Lexer::TokenType::EndOfFile:
-                    return;
-                [[unlikely]] default:
-                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+
+        void encode(Binary::Writer &out, const ConfigList &list) {
+            out.string(list.type);
+            out.varint(list.elements.size());
+            for (const auto *listElement : list.elements) {
+                out.varint(listElement->id);
+                out.byte(listElement->element != nullptr);
+                if (listElement->element != nullptr) {
+                    encode(out, *listElement->element);
+                }
             }
         }
-    }
 
-    //void verifyHelper(ConfigElement &configElement, Template::TemplateElement &templateElement, bool strict) {
-    //    if (configElement.type != templateElement.type) {
-    //        throw std::runtime_error(std::format("Type mismatch: expected {}, got {}", templateElement.type, configElement.type));
-    //    }
-    //    for (auto &attribute : templateElement.attributes) {
-    //        bool found = false;
-    //        for (uint32_t i = 0; i < configElement.attributes.size(); ++i) {
-    //            if (configElement.attributes[i]->name == attribute->name) {
-    //                found = true;
-    //                if ((std::holds_alternative<std::string>(configElement.attributes[i]->value) && attribute->type != Template::Type::String) ||
-    //                    (std::holds_alternative<int64_t>(configElement.attributes[i]->value) && attribute->type != Template::Type::Integer) ||
-    //                    (std::holds_alternative<bool>(configElement.attributes[i]->value) && attribute->type != Template::Type::Boolean)) {
-    //                    std::string value;
-    //                    if (std::holds_alternative<std::string>(configElement.attributes[i]->value)) {
-    //                        value = std::get<std::string>(configElement.attributes[i]->value);
-    //                    } else if (std::holds_alternative<int64_t>(configElement.attributes[i]->value)) {
-    //                        value = std::to_string(std::get<int64_t>(configElement.attributes[i]->value));
-    //                    } else if (std::holds_alternative<bool>(configElement.attributes[i]->value)) {
-    //                        value = std::get<bool>(configElement.attributes[i]->value) ? "true" : "false";
-    //                    }
-    //                    throw std::runtime_error(std::format("Type mismatch: expected {}, got value {}", Template::typeToString(attribute->type), value));
-    //                }
-    //                configElement.attributes.erase(configElement.attributes.begin() + i);
-    //            }
-    //        }
-    //        if (!found && attribute->required) {
-    //            throw std::runtime_error(std::format("Missing required attribute: {}", attribute->name));
-    //        }
-    //    }
-    //}
-
-    [[maybe_unused]] void ConfigRoot::verify(Template::TemplateRoot &configTemplate, bool strict) {
-        (void)configTemplate;
-        (void)strict;
-        throw std::runtime_error("Unimplemented");
-        //auto template_copy = configTemplate;
-        //auto config_copy = *this;
-
-        //uint32_t element_index = 0;
-
-        //while (element_index < config_copy.elements.size()) {
-        //
-        //}
-    }
+        ConfigList *decodeList(Binary::Reader &in, Generic::Allocator alloc);
 
-    [[maybe_unused]] std::string ConfigRoot::toString(size_t indent) {
-        std::string result;
-        result += std::format("ConfigName {}\n", this->name);
-        for (auto &import : this->imports) {
-            result += std::format("Import \"{}\"\n", import);
-        }
-        for (auto &element : this->elements) {
-            result += element->toString(indent, 0);
+        ConfigElement *decodeElement(Binary::Reader &in, Generic::Allocator alloc) {
+            auto *element = alloc.new_object<ConfigElement>(Symbol(in.string()), std::pmr::vector<ConfigElementAttribute*>(alloc), std::pmr::vector<ConfigList*>(alloc));
+            element->attributes.resize(in.count());
+            for (auto &attribute : element->attributes) {
+                Symbol name(in.string());
+                attribute = alloc.new_object<ConfigElementAttribute>(name, in.value(alloc));
+            }
+            element->lists.resize(in.count());
+            for (auto &list : element->lists) {
+                list = decodeList(in, alloc);
+            }
+            return element;
         }
-        for (auto &list : this->lists) {
-            result += list->toString(indent, 0);
+
+        ConfigList *decodeList(Binary::Reader &in, Generic::Allocator alloc) {
+            auto *list = alloc.new_object<ConfigList>(Symbol(in.string()), std::pmr::vector<ConfigListElement*>(alloc));
+            list->elements.resize(in.count());
+            for (auto &listElement : list->elements) {
+                size_t id = in.varint();
+                listElement = alloc.new_object<ConfigListElement>(id, in.byte() != 0 ? decodeElement(in, alloc) : nullptr);
+            }
+            return list;
         }
-        return result;
     }
 
-    ConfigList::ConfigList(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::ConfigList) {
-            throw std::runtime_error(std::format(R"(Expected "ConfigList" at line {}, column {}, got {})", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+    [[maybe_unused]] ConfigRoot ConfigRoot::fromBinary(std::string_view data) {
+        auto arena = std::make_shared<Generic::Arena>(data.size());
+        Generic::Allocator alloc(arena.get());
+        Binary::Reader in(data, 'C');
+        std::pmr::string name(in.string(), alloc);
+        std::pmr::vector<std::pmr::string> imports(in.count(), alloc);
+        for (auto &import : imports) {
+            import = in.string();
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw std::runtime_error(std::format("Expected Name at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+        std::pmr::vector<ConfigElement*> elements(in.count(), alloc);
+        for (auto &element : elements) {
+            element = decodeElement(in, alloc);
         }
-        this->type = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            if (tokens[index].type == Lexer::TokenType::ConfigListElement) {
-                this->elements.push_back(new ConfigListElement(tokens, index));
-            } else if (tokens[index].type == Lexer::TokenType::EndConfigList) {
-                index++;
-                break;
-            } else {
-                throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-            }
+        std::pmr::vector<ConfigList*> lists(in.count(), alloc);
+        for (auto &list : lists) {
+            list = decodeList(in, alloc);
         }
+        std::pmr::vector<size_t> listPositions(in.count(), alloc);
+        for (auto &position : listPositions) {
+            position = in.varint();
+        }
+        in.finish();
+        ConfigRoot root(std::move(name), std::move(imports), std::move(elements), std::move(lists));
+        root.listPositions = std::move(listPositions);
+        root.arena = std::move(arena);
+        return root;
     }
 
-    std::string ConfigList::toString(size_t indent, size_t indentStart) {
-        std::string result;
-        result += std::format("{}ConfigList {}\n", std::string(indentStart, ' '), this->type);
-        for (auto &element : this->elements) {
-            result += element->toString(indent, indentStart + indent);
-        }
-        result += std::string(indentStart, ' ') + "endConfigList\n";
-        return result;
+    [[maybe_unused]] ConfigRoot ConfigRoot::fromBinaryFile(const std::filesystem::path &path) {
+        SourceFile file(path);
+        return fromBinary(file.view());
     }
 
-    ConfigListElement::ConfigListElement(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::ConfigListElement) {
-            throw std::runtime_error(std::format(R"(Expected "ConfigListElement" at line {}, column {}, got {})", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+    [[maybe_unused]] std::string ConfigRoot::toBinary() const {
+        Binary::Writer out('C');
+        out.string(this->name);
+        out.varint(this->imports.size());
+        for (const auto &import : this->imports) {
+            out.string(import);
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::NumberLiteral) {
-            throw std::runtime_error(std::format("Expected NumberLiteral at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+        out.varint(this->elements.size());
+        for (const auto *element : this->elements) {
+            encode(out, *element);
         }
-        this->id = std::stoll(tokens[index].value);
-        index++;
-        while (index < tokens.size()) {
-            if (tokens[index].type == Lexer::TokenType::ConfigElement) {
-                if (this->element != nullptr) {
-                    throw std::runtime_error(std::format("Element already set at line {}, column {}", tokens[index].line, tokens[index].column));
+        out.varint(this->lists.size());
+        for (const auto *list : this->lists) {
+            encode(out, *list);
+        }
+        out.varint(this->listPositions.size());
+        for (size_t position : this->listPositions) {
+            out.varint(position);
+        }
+        return out.finish();
+    }
+
+    ConfigRoot::ConfigRoot(Lexer::TokenStream &tokens)
+        : ConfigRoot(tokens, std::make_shared<Generic::Arena>(tokens.sizeHint())) {}
+
+    namespace {
+        // Builds the tree from parser events. Every node is allocated as soon as it starts and attached to its
+        // parent right away, `frames` holds the nodes that are still open.
+        class TreeBuilder : public ConfigHandler {
+        public:
+            explicit TreeBuilder(ConfigRoot &root) : root(root), alloc(root.arena.get()) {}
+
+            void onConfigName(std::string_view name) override {
+                this->root.name = name;
+            }
+
+            void onImport(const Lexer::Token &path) override {
+                this->root.imports.push_back(path.unescaped(this->alloc));
+            }
+
+            Action onElementBegin(std::string_view type) override {
+                auto *element = this->alloc.new_object<ConfigElement>(Symbol(type), std::pmr::vector<ConfigElementAttribute*>(this->alloc), std::pmr::vector<ConfigList*>(this->alloc));
+                if (this->frames.empty()) {
+                    this->root.elements.push_back(element);
+                } else {
+                    this->frames.back().listElement->element = element;
+                }
+                this->frames.push_back({element, nullptr, nullptr});
+                return Action::Continue;
+            }
+
+            void onAttribute(std::string_view name, const Lexer::Token &value) override {
+                this->frames.back().element->attributes.push_back(this->alloc.new_object<ConfigElementAttribute>(Symbol(name), tokenValue(value, this->alloc)));
+            }
+
+            void onElementEnd() override {
+                this->frames.pop_back();
+            }
+
+            Action onListBegin(std::string_view type) override {
+                auto *list = this->alloc.new_object<ConfigList>(Symbol(type), std::pmr::vector<ConfigListElement*>(this->alloc));
+                if (this->frames.empty()) {
+                    this->root.lists.push_back(list);
+                    this->root.listPositions.push_back(this->root.elements.size());
+                } else {
+                    this->frames.back().element->lists.push_back(list);
                 }
-                this->element = new ConfigElement(tokens, index);
-            } else if (tokens[index].type == Lexer::TokenType::EndConfigListElement) {
-                index++;
-                break;
-            } else {
-                throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+                this->frames.push_back({nullptr, list, nullptr});
+                return Action::Continue;
+            }
+
+            Action onListElement(size_t id) override {
+                auto *listElement = this->alloc.new_object<ConfigListElement>(id, nullptr);
+                this->frames.back().list->elements.push_back(listElement);
+                this->frames.push_back({nullptr, nullptr, listElement});
+                return Action::Continue;
+            }
+
+            void onListElementEnd() override {
+                this->frames.pop_back();
+            }
+
+            void onListEnd() override {
+                this->frames.pop_back();
             }
+
+        private:
+            struct Frame {
+                ConfigElement *element;
+                ConfigList *list;
+                ConfigListElement *listElement;
+            };
+
+            ConfigRoot &root;
+            Generic::Allocator alloc;
+            std::vector<Frame> frames;
+        };
+    }
+
+    ConfigRoot::ConfigRoot(Lexer::TokenStream &tokens, std::shared_ptr<Generic::Arena> arena)
+        : arena(std::move(arena)), name(this->arena.get()), imports(this->arena.get()), elements(this->arena.get()), lists(this->arena.get()), listPositions(this->arena.get()) {
+        TreeBuilder builder(*this);
+        parse(tokens, builder);
+    }
+
+    [[maybe_unused]] void ConfigRoot::verify(Template::TemplateRoot &configTemplate, bool strict, bool parallel) {
+        std::vector<std::string> errors = Validator(configTemplate).validate(*this, strict, parallel);
+        if (errors.empty()) {
+            return;
+        }
+        std::string message = std::format("Configuration {} doesn't match template {}:", this->name, configTemplate.name);
+        for (const auto &error : errors) {
+            message += "\n" + error;
         }
+        throw std::runtime_error(message);
     }
 
-    std::string ConfigListElement::toString(size_t indent, size_t indentStart) {
+    [[maybe_unused]] std::string ConfigRoot::toString(size_t indent, bool parallel) {
         std::string result;
-        result += std::format("{}ConfigListElement {}\n", std::string(indentStart, ' '), this->id);
-        result += this->element->toString(indent, indentStart + indent);
-        result += std::string(indentStart, ' ') + "endConfigListElement\n";
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, parallel);
         return result;
     }
 
-    ConfigElement::ConfigElement(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::ConfigElement) {
-            throw std::runtime_error(std::format(R"(Expected "ConfigElement" at line {}, column {}, got {})", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-        }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw std::runtime_error(std::format("Expected Name at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-        }
-        this->type = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            if (tokens[index].type == Lexer::TokenType::Name) {
-                this->attributes.push_back(new ConfigElementAttribute(tokens, index));
-            } else if (tokens[index].type == Lexer::TokenType::ConfigList) {
-                this->lists.push_back(new ConfigList(tokens, index));
-            } else if (tokens[index].type == Lexer::TokenType::EndConfigElement) {
-                index++;
-                break;
-            } else {
-                throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-            }
-        }
+    std::string ConfigList::toString(size_t indent, size_t indentStart) {
+        std::string result;
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart);
+        return result;
     }
 
-    std::string ConfigElement::toString(size_t indent, size_t indentStart) {
+    std::string ConfigListElement::toString(size_t indent, size_t indentStart) {
         std::string result;
-        result += std::format("{}ConfigElement {}\n", std::string(indentStart, ' '), this->type);
-        for (auto &attribute : this->attributes) {
-            result += attribute->toString(indentStart + indent);
-        }
-        for (auto &list : this->lists) {
-            result += list->toString(indent, indentStart + indent);
-        }
-        result += std::string(indentStart, ' ') + "endConfigElement\n";
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart);
         return result;
     }
 
-    ConfigElementAttribute::ConfigElementAttribute(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw std::runtime_error(std::format("Expected Name at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-        }
-        this->name = tokens[index].value;
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Equals) {
-            throw std::runtime_error(std::format(R"(Expected "=" at line {}, column {}, got {})", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-        }
-        index++;
-        if (tokens[index].type == Lexer::TokenType::StringLiteral) {
-            this->value = tokens[index].value;
-        } else if (tokens[index].type == Lexer::TokenType::NumberLiteral) {
-            if (tokens[index].value.find('.') != std::string::npos) {
-                this->value = std::stod(tokens[index].value);
-            } else {
-                this->value = std::stoll(tokens[index].value);
-            }
-        } else if (tokens[index].type == Lexer::TokenType::BooleanLiteral) {
-            this->value = tokens[index].value == "true";
-        } else {
-            throw std::runtime_error(std::format("Expected StringLiteral, NumberLiteral or BooleanLiteral at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
-        }
-        index++;
+    std::string ConfigElement::toString(size_t indent, size_t indentStart) {
+        std::string result;
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart);
+        return result;
     }
 
     std::string ConfigElementAttribute::toString(size_t indent) {
         std::string result;
-        result += std::format("{}{} = ", std::string(indent, ' '), this->name);
-        if (std::holds_alternative<std::string>(this->value)) {
-            result += "\"" + std::get<std::string>(this->value) + "\"\n";
-        } else if (std::holds_alternative<int64_t>(this->value)) {
-            result += std::to_string(std::get<int64_t>(this->value)) + "\n";
-        } else if (std::holds_alternative<Generic::float64_t>(this->value)) {
-            result += std::format("{}\n", std::get<Generic::float64_t>(this->value)); // std::format doesn't give trailing 0s
-        } else if (std::holds_alternative<bool>(this->value)) {
-            result += std::get<bool>(this->value) ? "true\n" : "false\n";
-        }
+        StringSink sink(result);
+        Serializer(sink, 0).write(*this, indent);
         return result;
     }
 }
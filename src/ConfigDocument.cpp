@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <ConfigDocument.hpp>
+
+namespace PLCL::Config {
+    namespace {
+        template <typename T>
+        void splice(std::pmr::vector<T*> &nodes, size_t at, size_t count, const std::pmr::vector<T*> &with) {
+            auto position = nodes.erase(nodes.begin() + static_cast<ptrdiff_t>(at), nodes.begin() + static_cast<ptrdiff_t>(at + count));
+            nodes.insert(position, with.begin(), with.end());
+        }
+
+        Lexer::Token syntheticToken(Lexer::TokenType type, std::string_view value = "") {
+            return {type, value, 0, 0};
+        }
+    }
+
+    ConfigDocument::ConfigDocument(std::string source) : text(std::move(source)) {
+        this->parseAll();
+    }
+
+    void ConfigDocument::edit(size_t begin, size_t end, std::string_view replacement) {
+        if (begin > end || end > this->text.size()) {
+            throw std::runtime_error(std::format("Edit range [{}, {}) is outside the source of {} bytes", begin, end, this->text.size()));
+        }
+        this->text.replace(begin, end - begin, replacement);
+        // Replaced nodes stay in the arena until the next full parse, which costs about as much as reparsing the
+        // whole source once, so it's done when they add up to that.
+        if (this->stale || this->garbage >= this->text.size() || !this->reparse(this->spans, 0, {begin, end, replacement.size()})) {
+            this->stale = true;
+            this->parseAll();
+            return;
+        }
+        this->spans.end = this->text.size();
+    }
+
+    void ConfigDocument::parseAll() {
+        Lexer lexer(this->text);
+        std::vector<Lexer::Token> tokens = lexer.lex(true);
+        Lexer::TokenStream stream(tokens);
+        ConfigRoot root(stream, std::make_shared<Generic::Arena>(this->text.size()));
+
+        size_t index = 0;
+        Span spans = {Kind::Root, 0, this->text.size(), nullptr, scan(tokens, index, 0)};
+        attach(spans.children, root.elements, root.lists, {});
+
+        // Moving constructs the vectors with the new arena, assigning would keep the old one.
+        this->tree.reset();
+        this->tree.emplace(std::move(root));
+        this->spans = std::move(spans);
+        this->stale = false;
+        this->garbage = 0;
+    }
+
+    bool ConfigDocument::reparse(Span &container, size_t base, const Change &change) {
+        auto &children = container.children;
+        auto endingAfter = [&](size_t offset) {
+            auto child = std::ranges::partition_point(children, [&](const Span &span) {
+                return base + span.begin + span.end < offset;
+            });
+            return static_cast<size_t>(child - children.begin());
+        };
+        size_t first = endingAfter(change.begin);
+        size_t last = endingAfter(change.end);
+        if (last == children.size() || change.begin < base + children[first].begin) {
+            return false; // The edit touches the header or the end of the container
+        }
+
+        Span &child = children[first];
+        if (first == last && !child.children.empty() && this->reparse(child, base + child.begin, change)) {
+            child.end = change.moved(child.end);
+            for (size_t i = first + 1; i < children.size(); i++) {
+                children[i].begin = change.moved(children[i].begin);
+            }
+            return true;
+        }
+        return this->replace(container, base, first, last, change);
+    }
+
+    bool ConfigDocument::replace(Span &container, size_t base, size_t first, size_t last, const Change &change) {
+        auto &children = container.children;
+        // Only lists of an element are tracked, not its attributes. If attributes sit between the replaced lists they
+        // would be replaced too, but the tree would keep them, so the element is reparsed instead.
+        if (container.kind == Kind::Element) {
+            for (size_t i = first; i < last; i++) {
+                if (children[i].begin + children[i].end != children[i + 1].begin) {
+                    return false;
+                }
+            }
+        }
+        size_t begin = base + children[first].begin;
+        size_t end = change.moved(base + children[last].begin + children[last].end);
+
+        // Nothing before `begin` changed, so lexing from there gives the same tokens as lexing the whole source would.
+        // Once a token starts exactly where the old text after the replaced nodes starts, the old tokens from there
+        // on are still right, otherwise the edit leaked out of the range, e.g. by opening a string.
+        std::vector<Lexer::Token> tokens;
+        try {
+            Lexer lexer(std::string_view(this->text).substr(begin));
+            Lexer::Token token = lexer.pull();
+            while (token.offset < end - begin && token.type != Lexer::TokenType::EndOfFile) {
+                tokens.push_back(token);
+                token = lexer.pull();
+            }
+            if (token.offset != end - begin) {
+                return false;
+            }
+        } catch (const std::runtime_error &) {
+            return false;
+        }
+
+        // The new text has to be a run of whole nodes that can live in the container, it's parsed as the contents
+        // of a configuration, or of a list in one.
+        std::vector<Lexer::Token> wrapped = {syntheticToken(Lexer::TokenType::ConfigName), syntheticToken(Lexer::TokenType::Name, this->tree->name)};
+        if (container.kind == Kind::List) {
+            wrapped.push_back(syntheticToken(Lexer::TokenType::ConfigList));
+            wrapped.push_back(syntheticToken(Lexer::TokenType::Name, static_cast<ConfigList *>(container.node)->type));
+        }
+        wrapped.insert(wrapped.end(), tokens.begin(), tokens.end());
+        if (container.kind == Kind::List) {
+            wrapped.push_back(syntheticToken(Lexer::TokenType::EndConfigList));
+        }
+        wrapped.push_back(syntheticToken(Lexer::TokenType::EndOfFile));
+        std::optional<ConfigRoot> parsed;
+        try {
+            Lexer::TokenStream stream(wrapped);
+            parsed.emplace(stream, this->tree->arena);
+        } catch (const std::runtime_error &) {
+            return false;
+        }
+        if (!parsed->imports.empty()) {
+            return false;
+        }
+        if (container.kind == Kind::Element && !parsed->elements.empty()) {
+            return false;
+        }
+        if (container.kind == Kind::ListElement && (parsed->elements.size() != 1 || !parsed->lists.empty())) {
+            return false;
+        }
+
+        Lexer::Token endOfFile = syntheticToken(Lexer::TokenType::EndOfFile);
+        endOfFile.offset = end - begin;
+        tokens.push_back(endOfFile);
+        size_t index = 0;
+        std::vector<Span> spans = scan(tokens, index, 0);
+        for (auto &span : spans) {
+            span.begin += begin - base;
+        }
+        if (container.kind == Kind::List) {
+            attach(spans, {}, {}, parsed->lists.front()->elements);
+        } else {
+            attach(spans, parsed->elements, parsed->lists, {});
+        }
+
+        auto count = [&](size_t from, size_t to, Kind kind) {
+            return static_cast<size_t>(std::count_if(children.begin() + static_cast<ptrdiff_t>(from), children.begin() + static_cast<ptrdiff_t>(to), [&](const Span &span) {
+                return span.kind == kind;
+            }));
+        };
+        switch (container.kind) {
+            case Kind::Root:
+                splice(this->tree->elements, count(0, first, Kind::Element), count(first, last + 1, Kind::Element), parsed->elements);
+                splice(this->tree->lists, count(0, first, Kind::List), count(first, last + 1, Kind::List), parsed->lists);
+                break;
+            case Kind::Element:
+                splice(static_cast<ConfigElement *>(container.node)->lists, count(0, first, Kind::List), last + 1 - first, parsed->lists);
+                break;
+            case Kind::List:
+                splice(static_cast<ConfigList *>(container.node)->elements, first, last + 1 - first, parsed->lists.front()->elements);
+                break;
+            case Kind::ListElement:
+                static_cast<ConfigListElement *>(container.node)->element = parsed->elements.front();
+                break;
+        }
+
+        size_t next = first + spans.size();
+        children.erase(children.begin() + static_cast<ptrdiff_t>(first), children.begin() + static_cast<ptrdiff_t>(last + 1));
+        children.insert(children.begin() + static_cast<ptrdiff_t>(first), std::make_move_iterator(spans.begin()), std::make_move_iterator(spans.end()));
+        for (size_t i = next; i < children.size(); i++) {
+            children[i].begin = change.moved(children[i].begin);
+        }
+        if (container.kind == Kind::Root) {
+            this->tree->listPositions.clear();
+            size_t elements = 0;
+            for (const auto &span : children) {
+                if (span.kind == Kind::Element) {
+                    elements++;
+                } else {
+                    this->tree->listPositions.push_back(elements);
+                }
+            }
+        }
+        this->garbage += end - begin;
+        return true;
+    }
+
+    // Collects the nodes from `index` on, up to the token that closes the level they're on. The tokens must have
+    // been parsed successfully already, so every node is closed.
+    std::vector<ConfigDocument::Span> ConfigDocument::scan(const std::vector<Lexer::Token> &tokens, size_t &index, size_t base) {
+        std::vector<Span> spans;
+        while (index < tokens.size()) {
+            Kind kind;
+            switch (tokens[index].type) {
+                case Lexer::TokenType::ConfigElement:
+                    kind = Kind::Element;
+                    break;
+                case Lexer::TokenType::ConfigList:
+                    kind = Kind::List;
+                    break;
+                case Lexer::TokenType::ConfigListElement:
+                    kind = Kind::ListElement;
+                    break;
+                case Lexer::TokenType::EndConfigElement:
+                case Lexer::TokenType::EndConfigList:
+                case Lexer::TokenType::EndConfigListElement:
+                case Lexer::TokenType::EndOfFile:
+                    return spans;
+                default:
+                    index++;
+                    continue;
+            }
+            size_t begin = tokens[index].offset;
+            index++;
+            std::vector<Span> children = scan(tokens, index, begin);
+            index++;
+            spans.push_back({kind, begin - base, tokens[index].offset - begin, nullptr, std::move(children)});
+        }
+        return spans;
+    }
+
+    // Points spans at the nodes parsed from the same tokens. Every kind of node comes in the order of its spans.
+    void ConfigDocument::attach(std::vector<Span> &spans, std::span<ConfigElement *const> elements, std::span<ConfigList *const> lists, std::span<ConfigListElement *const> listElements) {
+        size_t element = 0;
+        size_t list = 0;
+        size_t listElement = 0;
+        for (auto &span : spans) {
+            switch (span.kind) {
+                case Kind::Element: {
+                    auto *node = elements[element++];
+                    span.node = node;
+                    attach(span.children, {}, node->lists, {});
+                    break;
+                }
+                case Kind::List: {
+                    auto *node = lists[list++];
+                    span.node = node;
+                    attach(span.children, {}, {}, node->elements);
+                    break;
+                }
+                case Kind::ListElement: {
+                    auto *node = listElements[listElement++];
+                    span.node = node;
+                    attach(span.children, {&node->element, node->element != nullptr ? 1u : 0u}, {}, {});
+                    break;
+                }
+                [[unlikely]] case Kind::Root:
+                    std::unreachable();
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ConfigHandle.hpp>
+#include <SourceFile.hpp>
+
+#if __has_include(<sys/inotify.h>)
+    #define PLCL_CONFIG_HANDLE_INOTIFY 1
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace PLCL::Config {
+    ConfigHandle::ConfigHandle(std::filesystem::path path, std::shared_ptr<const Validator> validator, bool strict)
+        : path(std::move(path)), validator(std::move(validator)), strict(strict) {
+        this->reload();
+    }
+
+    ConfigHandle::~ConfigHandle() {
+        if (this->watcher.joinable()) {
+            this->watcher.request_stop();
+#if PLCL_CONFIG_HANDLE_INOTIFY
+            ::eventfd_write(this->wake, 1);
+#endif
+            this->watcher.join();
+        }
+#if PLCL_CONFIG_HANDLE_INOTIFY
+        if (this->notify >= 0) {
+            ::close(this->notify);
+        }
+        if (this->wake >= 0) {
+            ::close(this->wake);
+        }
+#endif
+    }
+
+    void ConfigHandle::reload() {
+        // Held for the whole load, so a slow load can't publish over a newer one. Readers never take it.
+        std::scoped_lock lock(this->reloadMutex);
+        // Read rather than mapped, the file may be rewritten while it's parsed.
+        SourceFile file(this->path, false);
+        Lexer lexer(file.view());
+        Lexer::TokenStream tokens(lexer);
+        auto config = std::make_shared<const ConfigRoot>(tokens);
+        if (this->validator != nullptr) {
+            std::vector<std::string> errors = this->validator->validate(*config, this->strict);
+            if (!errors.empty()) {
+                std::string message = std::format("Configuration {} in {} doesn't match its template:", config->name, this->path.string());
+                for (const auto &error : errors) {
+                    message += "\n" + error;
+                }
+                throw std::runtime_error(message);
+            }
+        }
+        this->current.store(std::move(config), std::memory_order_release);
+    }
+
+#if PLCL_CONFIG_HANDLE_INOTIFY
+    void ConfigHandle::watch(ErrorHandler onError) {
+        if (this->watcher.joinable()) {
+            throw std::runtime_error(std::format("Already watching {}", this->path.string()));
+        }
+        this->notify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        this->wake = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        std::filesystem::path directory = this->path.has_parent_path() ? this->path.parent_path() : ".";
+        // Created files aren't watched for, they're usually still being written.
+        if (this->notify < 0 || this->wake < 0 || ::inotify_add_watch(this->notify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            std::runtime_error error(std::format("Couldn't watch {}: {}", this->path.string(), std::strerror(errno)));
+            if (this->notify >= 0) {
+                ::close(this->notify);
+            }
+            if (this->wake >= 0) {
+                ::close(this->wake);
+            }
+            this->notify = -1;
+            this->wake = -1;
+            throw error;
+        }
+        this->watcher = std::jthread([this, onError = std::move(onError)](const std::stop_token &stop) {
+            this->watchLoop(stop, onError);
+        });
+    }
+
+    void ConfigHandle::watchLoop(const std::stop_token &stop, const ErrorHandler &onError) {
+        std::string name = this->path.filename().string();
+        std::array<pollfd, 2> descriptors = {{{this->notify, POLLIN, 0}, {this->wake, POLLIN, 0}}};
+        alignas(inotify_event) std::array<char, 4096> buffer;
+        while (!stop.stop_requested()) {
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (onError) {
+                    onError(std::runtime_error(std::format("Stopped watching {}: {}", this->path.string(), std::strerror(errno))));
+                }
+                return;
+            }
+            // Saving a file usually takes several events, they're all drained before reloading once.
+            bool changed = false;
+            ssize_t size;
+            while ((size = ::read(this->notify, buffer.data(), buffer.size())) > 0) {
+                for (ssize_t offset = 0; offset < size;) {
+                    const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+                    if ((event->mask & IN_Q_OVERFLOW) != 0 || (event->len != 0 && name == event->name)) {
+                        changed = true;
+                    }
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+            if (!changed || stop.stop_requested()) {
+                continue;
+            }
+            try {
+                this->reload();
+            } catch (const std::exception &error) {
+                if (onError) {
+                    onError(error);
+                }
+            }
+        }
+    }
+#else
+    void ConfigHandle::watch(ErrorHandler onError) {
+        if (this->watcher.joinable()) {
+            throw std::runtime_error(std::format("Already watching {}", this->path.string()));
+        }
+        this->watcher = std::jthread([this, onError = std::move(onError)](const std::stop_token &stop) {
+            this->watchLoop(stop, onError);
+        });
+    }
+
+    void ConfigHandle::watchLoop(const std::stop_token &stop, const ErrorHandler &onError) {
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(this->path, error);
+        std::mutex mutex;
+        std::condition_variable_any sleeper;
+        std::unique_lock lock(mutex);
+        while (!stop.stop_requested()) {
+            sleeper.wait_for(lock, stop, pollInterval, [] { return false; });
+            auto time = std::filesystem::last_write_time(this->path, error);
+            if (stop.stop_requested() || error || time == modified) {
+                continue;
+            }
+            modified = time;
+            try {
+                this->reload();
+            } catch (const std::exception &failure) {
+                if (onError) {
+                    onError(failure);
+                }
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <format>
+#include <stdexcept>
+#include <ConfigHandler.hpp>
+
+namespace PLCL::Config {
+    namespace {
+        class Parser {
+        public:
+            Parser(Lexer::TokenStream &tokens, ConfigHandler &handler) : tokens(tokens), handler(handler) {}
+
+            void root() {
+                this->expect(Lexer::TokenType::ConfigName, R"("ConfigName")");
+                this->handler.onConfigName(this->expect(Lexer::TokenType::Name, "Name").value);
+                while (true) {
+                    switch (this->tokens.peek().type) {
+                        case Lexer::TokenType::Import:
+                            this->tokens.advance();
+                            this->handler.onImport(this->expect(Lexer::TokenType::StringLiteral, "string"));
+                            break;
+                        case Lexer::TokenType::ConfigElement:
+                            this->element();
+                            break;
+                        case Lexer::TokenType::ConfigList:
+                            this->list();
+                            break;
+                        case Lexer::TokenType::EndOfFile:
+                            return;
+                        [[unlikely]] default:
+                            throw this->unexpected();
+                    }
+                }
+            }
+
+        private:
+            Lexer::TokenStream &tokens;
+            ConfigHandler &handler;
+
+            std::runtime_error unexpected() {
+                const auto &token = this->tokens.peek();
+                return std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", token.line, token.column, Lexer::tokenTypeToString(token.type)));
+            }
+
+            Lexer::Token expect(Lexer::TokenType type, std::string_view what) {
+                Lexer::Token token = this->tokens.peek();
+                if (token.type != type) {
+                    throw std::runtime_error(std::format("Expected {} at line {}, column {}, got {}", what, token.line, token.column, Lexer::tokenTypeToString(token.type)));
+                }
+                this->tokens.advance();
+                return token;
+            }
+
+            // Fast-forwards past the end of a subtree whose header was already consumed, without looking at anything
+            // but the tokens that open and close it.
+            void skip(Lexer::TokenType begin, Lexer::TokenType end) {
+                size_t depth = 1;
+                while (depth != 0) {
+                    Lexer::TokenType type = this->tokens.peek().type;
+                    if (type == begin) {
+                        depth++;
+                    } else if (type == end) {
+                        depth--;
+                    } else if (type == Lexer::TokenType::EndOfFile) {
+                        throw this->unexpected();
+                    }
+                    this->tokens.advance();
+                }
+            }
+
+            void element() {
+                this->expect(Lexer::TokenType::ConfigElement, R"("ConfigElement")");
+                if (this->handler.onElementBegin(this->expect(Lexer::TokenType::Name, "Name").value) == ConfigHandler::Action::SkipSubtree) {
+                    this->skip(Lexer::TokenType::ConfigElement, Lexer::TokenType::EndConfigElement);
+                    return;
+                }
+                while (true) {
+                    if (this->tokens.peek().type == Lexer::TokenType::Name) {
+                        this->attribute();
+                    } else if (this->tokens.peek().type == Lexer::TokenType::ConfigList) {
+                        this->list();
+                    } else if (this->tokens.peek().type == Lexer::TokenType::EndConfigElement) {
+                        this->tokens.advance();
+                        break;
+                    } else {
+                        throw this->unexpected();
+                    }
+                }
+                this->handler.onElementEnd();
+            }
+
+            void attribute() {
+                Lexer::Token name = this->expect(Lexer::TokenType::Name, "Name");
+                this->expect(Lexer::TokenType::Equals, R"("=")");
+                Lexer::Token value = this->tokens.peek();
+                if (value.type != Lexer::TokenType::StringLiteral && value.type != Lexer::TokenType::NumberLiteral && value.type != Lexer::TokenType::BooleanLiteral) {
+                    throw std::runtime_error(std::format("Expected StringLiteral, NumberLiteral or BooleanLiteral at line {}, column {}, got {}", value.line, value.column, Lexer::tokenTypeToString(value.type)));
+                }
+                this->tokens.advance();
+                this->handler.onAttribute(name.value, value);
+            }
+
+            void list() {
+                this->expect(Lexer::TokenType::ConfigList, R"("ConfigList")");
+                if (this->handler.onListBegin(this->expect(Lexer::TokenType::Name, "Name").value) == ConfigHandler::Action::SkipSubtree) {
+                    this->skip(Lexer::TokenType::ConfigList, Lexer::TokenType::EndConfigList);
+                    return;
+                }
+                while (true) {
+                    if (this->tokens.peek().type == Lexer::TokenType::ConfigListElement) {
+                        this->listElement();
+                    } else if (this->tokens.peek().type == Lexer::TokenType::EndConfigList) {
+                        this->tokens.advance();
+                        break;
+                    } else {
+                        throw this->unexpected();
+                    }
+                }
+                this->handler.onListEnd();
+            }
+
+            void listElement() {
+                this->expect(Lexer::TokenType::ConfigListElement, R"("ConfigListElement")");
+                const Lexer::Token &idToken = this->expect(Lexer::TokenType::NumberLiteral, "NumberLiteral");
+                if (idToken.isFloat || idToken.integerValue < 0) {
+                    throw Generic::genericExpectedError("a non-negative integer", idToken.value, idToken.line, idToken.column);
+                }
+                auto id = static_cast<size_t>(idToken.integerValue);
+                if (this->handler.onListElement(id) == ConfigHandler::Action::SkipSubtree) {
+                    this->skip(Lexer::TokenType::ConfigListElement, Lexer::TokenType::EndConfigListElement);
+                    return;
+                }
+                bool hasElement = false;
+                while (true) {
+                    if (this->tokens.peek().type == Lexer::TokenType::ConfigElement) {
+                        if (hasElement) {
+                            throw std::runtime_error(std::format("Element already set at line {}, column {}", this->tokens.peek().line, this->tokens.peek().column));
+                        }
+                        hasElement = true;
+                        this->element();
+                    } else if (this->tokens.peek().type == Lexer::TokenType::EndConfigListElement) {
+                        this->tokens.advance();
+                        break;
+                    } else {
+                        throw this->unexpected();
+                    }
+                }
+                this->handler.onListElementEnd();
+            }
+        };
+    }
+
+    void parse(Lexer::TokenStream &tokens, ConfigHandler &handler) {
+        Parser(tokens, handler).root();
+    }
+
+    Generic::Value tokenValue(const Lexer::Token &token, Generic::Allocator alloc) {
+        switch (token.type) {
+            case Lexer::TokenType::StringLiteral:
+                if (token.escaped) {
+                    return Generic::Value::copy(token.unescaped(), alloc);
+                }
+                return Generic::Value::copy(token.value, alloc);
+            case Lexer::TokenType::NumberLiteral:
+                if (token.isFloat) {
+                    return token.floatValue;
+                }
+                return token.integerValue;
+            case Lexer::TokenType::BooleanLiteral:
+                return token.value == "true";
+            [[unlikely]] default:
+                throw std::runtime_error(std::format("Expected StringLiteral, NumberLiteral or BooleanLiteral at line {}, column {}, got {}", token.line, token.column, Lexer::tokenTypeToString(token.type)));
+        }
+    }
+}
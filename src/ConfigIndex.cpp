@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <charconv>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <ConfigIndex.hpp>
+
+namespace PLCL::Config {
+    ConfigIndex::ConfigIndex(const ConfigRoot &root) : root(&root), arena(root.arena) {
+        for (const auto *element : root.elements) {
+            this->elements.try_emplace({&root, element->type}, element);
+            this->add(element);
+        }
+        this->add(&root, root.lists);
+    }
+
+    void ConfigIndex::add(const void *parent, const std::pmr::vector<ConfigList *> &children) {
+        for (const auto *list : children) {
+            this->lists.try_emplace({parent, list->type}, list);
+            for (const auto *listElement : list->elements) {
+                if (listElement->element == nullptr) {
+                    continue;
+                }
+                this->listElements.try_emplace({list, listElement->id}, listElement->element);
+                this->add(listElement->element);
+            }
+        }
+    }
+
+    void ConfigIndex::add(const ConfigElement *element) {
+        for (const auto *attribute : element->attributes) {
+            this->attributes.try_emplace({element, attribute->name}, &attribute->value);
+        }
+        this->add(element, element->lists);
+    }
+
+    // Follows one segment of a path from the root or an element, to an element or the element of a list element.
+    const ConfigElement *ConfigIndex::step(const void *node, std::string_view segment) const {
+        size_t bracket = segment.find('[');
+        if (bracket == std::string_view::npos) {
+            std::optional<Symbol> name = Symbol::find(segment);
+            if (!name) {
+                return nullptr;
+            }
+            auto element = this->elements.find({node, *name});
+            return element != this->elements.end() ? element->second : nullptr;
+        }
+        size_t id = 0;
+        std::string_view digits = segment.substr(bracket + 1);
+        auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), id);
+        if (error != std::errc() || end + 1 != digits.data() + digits.size() || *end != ']') {
+            throw std::runtime_error(std::format("Expected a list element id in brackets in path segment {}", segment));
+        }
+        std::optional<Symbol> name = Symbol::find(segment.substr(0, bracket));
+        if (!name) {
+            return nullptr;
+        }
+        auto list = this->lists.find({node, *name});
+        if (list == this->lists.end()) {
+            return nullptr;
+        }
+        auto element = this->listElements.find({list->second, id});
+        return element != this->listElements.end() ? element->second : nullptr;
+    }
+
+    // Follows every segment of the path but the last, which is returned in `last`. Returns the node the last segment
+    // belongs to, the root or an element, or null if there's nothing at that path.
+    const void *ConfigIndex::resolve(std::string_view path, std::string_view &last) const {
+        const void *node = this->root;
+        size_t begin = 0;
+        while (node != nullptr) {
+            size_t dot = path.find('.', begin);
+            std::string_view segment = path.substr(begin, dot - begin);
+            if (segment.empty()) {
+                throw std::runtime_error(std::format("Empty segment in path {}", path));
+            }
+            if (dot == std::string_view::npos) {
+                last = segment;
+                return node;
+            }
+            node = this->step(node, segment);
+            begin = dot + 1;
+        }
+        return nullptr;
+    }
+
+    const Generic::Value *ConfigIndex::find(std::string_view path) const {
+        std::string_view name;
+        const void *node = this->resolve(path, name);
+        if (node == nullptr) {
+            return nullptr;
+        }
+        // A name that was never interned can't be the name of any attribute.
+        std::optional<Symbol> symbol = Symbol::find(name);
+        if (!symbol) {
+            return nullptr;
+        }
+        auto attribute = this->attributes.find({node, *symbol});
+        return attribute != this->attributes.end() ? attribute->second : nullptr;
+    }
+
+    const ConfigElement *ConfigIndex::findElement(std::string_view path) const {
+        std::string_view name;
+        const void *node = this->resolve(path, name);
+        return node != nullptr ? this->step(node, name) : nullptr;
+    }
+}
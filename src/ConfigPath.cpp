@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <charconv>
+#include <format>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <ConfigPath.hpp>
+
+namespace PLCL::Config {
+    SlotLayout::SlotLayout(const Template::TemplateRoot &configTemplate) {
+        this->shapes.emplace_back();
+        for (const auto *element : configTemplate.elements) {
+            uint32_t shape = this->addShape(*element);
+            this->shapes[0].elements.try_emplace(element->type, shape);
+        }
+        for (const auto *list : configTemplate.lists) {
+            uint32_t shape = this->addShape(*list);
+            this->shapes[0].lists.try_emplace(list->type, shape);
+        }
+        this->instantiate(0);
+    }
+
+    uint32_t SlotLayout::addShape(const Template::TemplateElement &element) {
+        auto index = static_cast<uint32_t>(this->shapes.size());
+        this->shapes.push_back({element.type, {}, {}, {}});
+        for (const auto *attribute : element.attributes) {
+            this->shapes[index].attributes.emplace_back(attribute->name, attribute->type);
+        }
+        for (const auto *list : element.lists) {
+            uint32_t child = this->addShape(*list);
+            this->shapes[index].lists.try_emplace(list->type, child);
+        }
+        return index;
+    }
+
+    uint32_t SlotLayout::addShape(const Template::TemplateList &list) {
+        auto index = static_cast<uint32_t>(this->listShapes.size());
+        this->listShapes.emplace_back();
+        for (const auto *listElement : list.elements) {
+            if (listElement->element == nullptr) {
+                continue;
+            }
+            uint32_t child = this->addShape(*listElement->element);
+            this->listShapes[index].elements.try_emplace(listElement->element->type, child);
+        }
+        return index;
+    }
+
+    // Adds a node for a shape, along with the nodes of its elements and its lists, but none for list elements.
+    uint32_t SlotLayout::instantiate(uint32_t shape) const {
+        auto index = static_cast<uint32_t>(this->nodes.size());
+        this->nodes.push_back({this->shapes[shape].type, {}, {}, {}});
+        for (const auto &[name, type] : this->shapes[shape].attributes) {
+            if (this->nodes[index].attributes.try_emplace(name, Slot{this->slots, type}).second) {
+                this->slots++;
+            }
+        }
+        for (const auto &[type, element] : this->shapes[shape].elements) {
+            uint32_t child = this->instantiate(element);
+            this->nodes[index].elements.try_emplace(type, child);
+        }
+        for (const auto &[type, list] : this->shapes[shape].lists) {
+            auto child = static_cast<uint32_t>(this->lists.size());
+            this->lists.push_back({list, {}});
+            this->nodes[index].lists.try_emplace(type, child);
+        }
+        return index;
+    }
+
+    namespace {
+        // Segments are never empty, and neither are the names in a template, so a name that was never interned is
+        // looked up as the empty symbol and isn't found.
+        Symbol interned(std::string_view name) {
+            return Symbol::find(name).value_or(Symbol());
+        }
+    }
+
+    SlotLayout::Slot SlotLayout::slot(std::string_view path) const {
+        {
+            std::shared_lock lock(this->mutex);
+            if (std::optional<Slot> slot = this->resolve(path, false)) {
+                return *slot;
+            }
+        }
+        std::unique_lock lock(this->mutex);
+        return *this->resolve(path, true);
+    }
+
+    // Returns nothing if the path picks a list element that has no node yet and `add` is false.
+    std::optional<SlotLayout::Slot> SlotLayout::resolve(std::string_view path, bool add) const {
+        uint32_t node = 0;
+        size_t begin = 0;
+        while (true) {
+            size_t dot = path.find('.', begin);
+            std::string_view segment = path.substr(begin, dot - begin);
+            if (segment.empty()) {
+                throw std::runtime_error(std::format("Empty segment in path {}", path));
+            }
+            const Node &current = this->nodes[node];
+            if (dot == std::string_view::npos) {
+                auto attribute = current.attributes.find(interned(segment));
+                if (attribute == current.attributes.end()) {
+                    throw std::runtime_error(std::format("The template has no attribute at {}", path));
+                }
+                return attribute->second;
+            }
+            begin = dot + 1;
+
+            size_t bracket = segment.find('[');
+            if (bracket == std::string_view::npos) {
+                auto element = current.elements.find(interned(segment));
+                if (element == current.elements.end()) {
+                    throw std::runtime_error(std::format("The template has no element {} in path {}", segment, path));
+                }
+                node = element->second;
+                continue;
+            }
+            size_t id = 0;
+            std::string_view digits = segment.substr(bracket + 1);
+            auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), id);
+            if (error != std::errc() || end + 1 != digits.data() + digits.size() || *end != ']') {
+                throw std::runtime_error(std::format("Expected a list element id in brackets in path segment {}", segment));
+            }
+            auto list = current.lists.find(interned(segment.substr(0, bracket)));
+            if (list == current.lists.end()) {
+                throw std::runtime_error(std::format("The template has no list {} in path {}", segment.substr(0, bracket), path));
+            }
+            uint32_t listIndex = list->second;
+            auto element = this->lists[listIndex].elements.find(id);
+            if (element != this->lists[listIndex].elements.end()) {
+                node = element->second;
+                continue;
+            }
+            const ListShape &shape = this->listShapes[this->lists[listIndex].shape];
+            if (shape.elements.empty()) {
+                throw std::runtime_error(std::format("The template has no elements in list {} in path {}", segment.substr(0, bracket), path));
+            }
+            if (shape.elements.size() > 1) {
+                throw std::runtime_error(std::format("The template allows several element types in list {}, path {} is ambiguous", segment.substr(0, bracket), path));
+            }
+            if (!add) {
+                return std::nullopt;
+            }
+            node = this->instantiate(shape.elements.begin()->second);
+            this->lists[listIndex].elements.emplace(id, node);
+        }
+    }
+
+    // Walks a configuration alongside the layout. Every node and list of the layout is bound to the first element or
+    // list of the configuration that matches it, later ones are skipped.
+    class SlotLayout::Binder {
+    public:
+        Binder(const SlotLayout &layout, SlotTable &table) : layout(layout), table(table), bound(layout.nodes.size()), boundLists(layout.lists.size()) {}
+
+        void root(const ConfigRoot &config) {
+            const Node &root = this->layout.nodes[0];
+            for (const auto *element : config.elements) {
+                auto node = root.elements.find(element->type);
+                if (node != root.elements.end()) {
+                    this->element(node->second, *element);
+                }
+            }
+            this->lists(root, config.lists);
+        }
+
+    private:
+        const SlotLayout &layout;
+        SlotTable &table;
+        std::vector<bool> bound;
+        std::vector<bool> boundLists;
+
+        void element(uint32_t index, const ConfigElement &element) {
+            if (this->bound[index]) {
+                return;
+            }
+            this->bound[index] = true;
+            const Node &node = this->layout.nodes[index];
+            for (const auto *attribute : element.attributes) {
+                auto slot = node.attributes.find(attribute->name);
+                if (slot != node.attributes.end() && this->table.values[slot->second.index] == nullptr) {
+                    this->table.values[slot->second.index] = &attribute->value;
+                }
+            }
+            this->lists(node, element.lists);
+        }
+
+        void lists(const Node &node, const std::pmr::vector<ConfigList *> &lists) {
+            for (const auto *list : lists) {
+                auto index = node.lists.find(list->type);
+                if (index == node.lists.end() || this->boundLists[index->second]) {
+                    continue;
+                }
+                this->boundLists[index->second] = true;
+                const List &layoutList = this->layout.lists[index->second];
+                if (layoutList.elements.empty()) {
+                    continue;
+                }
+                for (const auto *listElement : list->elements) {
+                    auto child = layoutList.elements.find(listElement->id);
+                    if (child == layoutList.elements.end() || listElement->element == nullptr || this->layout.nodes[child->second].type != listElement->element->type) {
+                        continue;
+                    }
+                    this->element(child->second, *listElement->element);
+                }
+            }
+        }
+    };
+
+    SlotTable SlotLayout::bind(const ConfigRoot &config) const {
+        std::shared_lock lock(this->mutex);
+        SlotTable table;
+        table.source = this;
+        table.arena = config.arena;
+        table.values.resize(this->slots);
+        Binder(*this, table).root(config);
+        return table;
+    }
+}
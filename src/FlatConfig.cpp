@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <memory>
+#include <vector>
+#include <ConfigHandler.hpp>
+#include <FlatConfig.hpp>
+#include <SourceFile.hpp>
+
+namespace PLCL::Config {
+    namespace {
+        struct Element {
+            FlatConfig::String type;
+            FlatConfig::Range attributes;
+            FlatConfig::Range lists;
+        };
+
+        struct Attribute {
+            FlatConfig::String name;
+            Generic::Value value;
+        };
+
+        struct List {
+            FlatConfig::String type;
+            FlatConfig::Range elements;
+        };
+
+        struct ListElement {
+            size_t id;
+            uint32_t element;
+        };
+
+        // Children are parked on these stacks until their parent is finished, and are then moved into the document
+        // all at once. Nested nodes always finish before their parent does, so each parent's children end up
+        // contiguous.
+        struct Builder {
+            FlatConfig &config;
+            std::vector<Element> elements;
+            std::vector<Attribute> attributes;
+            std::vector<List> lists;
+            std::vector<ListElement> listElements;
+
+            explicit Builder(FlatConfig &config) : config(config) {
+                this->config.arena = std::make_shared<Generic::Arena>();
+            }
+
+            FlatConfig::String string(std::string_view value) {
+                FlatConfig::String result = {static_cast<uint32_t>(this->config.strings.size()), static_cast<uint32_t>(value.size())};
+                this->config.strings += value;
+                return result;
+            }
+
+            Generic::Value value(const Generic::Value &value) {
+                if (auto string = Generic::get_if<std::string_view>(&value)) {
+                    return Generic::Value::copy(*string, this->config.arena.get());
+                }
+                return value;
+            }
+
+            uint32_t addElement(const Element &element) {
+                this->config.elementTypes.push_back(element.type);
+                this->config.elementAttributes.push_back(element.attributes);
+                this->config.elementLists.push_back(element.lists);
+                return static_cast<uint32_t>(this->config.elementTypes.size() - 1);
+            }
+
+            FlatConfig::Range flushElements(size_t mark) {
+                FlatConfig::Range range = {static_cast<uint32_t>(this->config.elementTypes.size()), static_cast<uint32_t>(this->elements.size() - mark)};
+                for (size_t i = mark; i < this->elements.size(); i++) {
+                    this->addElement(this->elements[i]);
+                }
+                this->elements.resize(mark);
+                return range;
+            }
+
+            FlatConfig::Range flushAttributes(size_t mark) {
+                FlatConfig::Range range = {static_cast<uint32_t>(this->config.attributeNames.size()), static_cast<uint32_t>(this->attributes.size() - mark)};
+                for (size_t i = mark; i < this->attributes.size(); i++) {
+                    this->config.attributeNames.push_back(this->attributes[i].name);
+                    this->config.attributeValues.push_back(this->attributes[i].value);
+                }
+                this->attributes.resize(mark);
+                return range;
+            }
+
+            FlatConfig::Range flushLists(size_t mark) {
+                FlatConfig::Range range = {static_cast<uint32_t>(this->config.listTypes.size()), static_cast<uint32_t>(this->lists.size() - mark)};
+                for (size_t i = mark; i < this->lists.size(); i++) {
+                    this->config.listTypes.push_back(this->lists[i].type);
+                    this->config.listElements.push_back(this->lists[i].elements);
+                }
+                this->lists.resize(mark);
+                return range;
+            }
+
+            FlatConfig::Range flushListElements(size_t mark) {
+                FlatConfig::Range range = {static_cast<uint32_t>(this->config.listElementIds.size()), static_cast<uint32_t>(this->listElements.size() - mark)};
+                for (size_t i = mark; i < this->listElements.size(); i++) {
+                    this->config.listElementIds.push_back(this->listElements[i].id);
+                    this->config.listElementElements.push_back(this->listElements[i].element);
+                }
+                this->listElements.resize(mark);
+                return range;
+            }
+        };
+
+        // Builds the document from parser events. `frames` holds the nodes that are still open, along with the size
+        // of the scratch stacks when they started, which is where their children begin.
+        class FlatBuilder : public ConfigHandler {
+        public:
+            explicit FlatBuilder(FlatConfig &config) : builder(config) {}
+
+            void finish() {
+                this->builder.config.rootElements = this->builder.flushElements(0);
+                this->builder.config.rootLists = this->builder.flushLists(0);
+            }
+
+            void onConfigName(std::string_view name) override {
+                this->builder.config.name = this->builder.string(name);
+            }
+
+            void onImport(const Lexer::Token &path) override {
+                this->builder.config.imports.push_back(this->builder.string(path.unescaped()));
+            }
+
+            Action onElementBegin(std::string_view type) override {
+                this->frames.push_back({this->builder.string(type), this->builder.attributes.size(), this->builder.lists.size(), 0, 0, FlatConfig::noElement});
+                return Action::Continue;
+            }
+
+            void onAttribute(std::string_view name, const Lexer::Token &value) override {
+                this->builder.attributes.push_back({this->builder.string(name), tokenValue(value, this->builder.config.arena.get())});
+            }
+
+            void onElementEnd() override {
+                Frame frame = this->frames.back();
+                this->frames.pop_back();
+                Element element = {frame.type, this->builder.flushAttributes(frame.attributes), this->builder.flushLists(frame.lists)};
+                if (this->frames.empty()) {
+                    this->builder.elements.push_back(element);
+                } else {
+                    this->frames.back().element = this->builder.addElement(element);
+                }
+            }
+
+            Action onListBegin(std::string_view type) override {
+                this->frames.push_back({this->builder.string(type), 0, 0, this->builder.listElements.size(), 0, FlatConfig::noElement});
+                return Action::Continue;
+            }
+
+            Action onListElement(size_t id) override {
+                this->frames.push_back({{}, 0, 0, 0, id, FlatConfig::noElement});
+                return Action::Continue;
+            }
+
+            void onListElementEnd() override {
+                this->builder.listElements.push_back({this->frames.back().id, this->frames.back().element});
+                this->frames.pop_back();
+            }
+
+            void onListEnd() override {
+                Frame frame = this->frames.back();
+                this->frames.pop_back();
+                this->builder.lists.push_back({frame.type, this->builder.flushListElements(frame.listElements)});
+            }
+
+        private:
+            struct Frame {
+                FlatConfig::String type;
+                size_t attributes;
+                size_t lists;
+                size_t listElements;
+                size_t id;
+                uint32_t element;
+            };
+
+            Builder builder;
+            std::vector<Frame> frames;
+        };
+
+        class Flattener {
+        public:
+            explicit Flattener(FlatConfig &config) : builder(config) {}
+
+            void root(const ConfigRoot &root) {
+                this->builder.config.name = this->builder.string(root.name);
+                for (const auto &import : root.imports) {
+                    this->builder.config.imports.push_back(this->builder.string(import));
+                }
+                for (const auto *element : root.elements) {
+                    this->builder.elements.push_back(this->element(*element));
+                }
+                for (const auto *list : root.lists) {
+                    this->builder.lists.push_back(this->list(*list));
+                }
+                this->builder.config.rootElements = this->builder.flushElements(0);
+                this->builder.config.rootLists = this->builder.flushLists(0);
+            }
+
+        private:
+            Builder builder;
+
+            Element element(const ConfigElement &element) {
+                Element result = {this->builder.string(element.type), {}, {}};
+                size_t attributes = this->builder.attributes.size();
+                size_t lists = this->builder.lists.size();
+                for (const auto *attribute : element.attributes) {
+                    this->builder.attributes.push_back({this->builder.string(attribute->name), this->builder.value(attribute->value)});
+                }
+                for (const auto *list : element.lists) {
+                    this->builder.lists.push_back(this->list(*list));
+                }
+                result.attributes = this->builder.flushAttributes(attributes);
+                result.lists = this->builder.flushLists(lists);
+                return result;
+            }
+
+            List list(const ConfigList &list) {
+                List result = {this->builder.string(list.type), {}};
+                size_t listElements = this->builder.listElements.size();
+                for (const auto *listElement : list.elements) {
+                    uint32_t element = FlatConfig::noElement;
+                    if (listElement->element != nullptr) {
+                        element = this->builder.addElement(this->element(*listElement->element));
+                    }
+                    this->builder.listElements.push_back({listElement->id, element});
+                }
+                result.elements = this->builder.flushListElements(listElements);
+                return result;
+            }
+        };
+
+        class Unflattener {
+        public:
+            explicit Unflattener(const FlatConfig &config)
+                : config(config), arena(std::make_shared<Generic::Arena>(config.strings.size() + config.attributeNames.size() * sizeof(ConfigElementAttribute))), alloc(arena.get()) {}
+
+            ConfigRoot root() {
+                std::pmr::vector<std::pmr::string> imports(this->alloc);
+                for (const auto &import : this->config.imports) {
+                    imports.emplace_back(this->config.string(import));
+                }
+                std::pmr::vector<ConfigElement*> elements(this->alloc);
+                for (uint32_t i = 0; i < this->config.rootElements.count; i++) {
+                    elements.push_back(this->element(this->config.rootElements.begin + i));
+                }
+                ConfigRoot root(this->string(this->config.name), std::move(imports), std::move(elements), this->lists(this->config.rootLists));
+                root.arena = this->arena;
+                return root;
+            }
+
+        private:
+            const FlatConfig &config;
+            std::shared_ptr<Generic::Arena> arena;
+            Generic::Allocator alloc;
+
+            std::pmr::string string(FlatConfig::String string) {
+                return std::pmr::string(this->config.string(string), this->alloc);
+            }
+
+            Symbol symbol(FlatConfig::String string) {
+                return Symbol(this->config.string(string));
+            }
+
+            ConfigElement *element(uint32_t index) {
+                FlatConfig::Range range = this->config.elementAttributes[index];
+                std::pmr::vector<ConfigElementAttribute*> attributes(this->alloc);
+                attributes.reserve(range.count);
+                for (uint32_t i = range.begin; i < range.begin + range.count; i++) {
+                    Generic::Value value = this->config.attributeValues[i];
+                    if (auto string = Generic::get_if<std::string_view>(&value)) {
+                        value = Generic::Value::copy(*string, this->alloc);
+                    }
+                    attributes.push_back(this->alloc.new_object<ConfigElementAttribute>(this->symbol(this->config.attributeNames[i]), value));
+                }
+                return this->alloc.new_object<ConfigElement>(this->symbol(this->config.elementTypes[index]), std::move(attributes), this->lists(this->config.elementLists[index]));
+            }
+
+            std::pmr::vector<ConfigList*> lists(FlatConfig::Range range) {
+                std::pmr::vector<ConfigList*> result(this->alloc);
+                result.reserve(range.count);
+                for (uint32_t i = range.begin; i < range.begin + range.count; i++) {
+                    FlatConfig::Range listElements = this->config.listElements[i];
+                    std::pmr::vector<ConfigListElement*> elements(this->alloc);
+                    elements.reserve(listElements.count);
+                    for (uint32_t j = listElements.begin; j < listElements.begin + listElements.count; j++) {
+                        uint32_t element = this->config.listElementElements[j];
+                        elements.push_back(this->alloc.new_object<ConfigListElement>(this->config.listElementIds[j], element == FlatConfig::noElement ? nullptr : this->element(element)));
+                    }
+                    result.push_back(this->alloc.new_object<ConfigList>(this->symbol(this->config.listTypes[i]), std::move(elements)));
+                }
+                return result;
+            }
+        };
+    }
+
+    FlatConfig::FlatConfig(Lexer::TokenStream &tokens) {
+        FlatBuilder builder(*this);
+        parse(tokens, builder);
+        builder.finish();
+    }
+
+    FlatConfig::FlatConfig(const ConfigRoot &root) {
+        Flattener(*this).root(root);
+    }
+
+    [[maybe_unused]] FlatConfig FlatConfig::fromString(std::string_view input) {
+        Lexer lexer(input);
+        Lexer::TokenStream tokens(lexer);
+        return FlatConfig(tokens);
+    }
+
+    [[maybe_unused]] FlatConfig FlatConfig::fromFile(const std::filesystem::path &path) {
+        SourceFile file(path);
+        Lexer lexer(file.view());
+        Lexer::TokenStream tokens(lexer);
+        return FlatConfig(tokens);
+    }
+
+    [[maybe_unused]] ConfigRoot FlatConfig::toTree() const {
+        return Unflattener(*this).root();
+    }
+}
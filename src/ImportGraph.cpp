@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <ImportGraph.hpp>
+#include <Parallel.hpp>
+
+namespace PLCL::Config {
+    namespace {
+        enum class Visit : uint8_t {
+            New,
+            Open,
+            Done,
+        };
+
+        bool findCycle(const std::vector<ImportGraph::File> &files, size_t index, std::vector<Visit> &visits, std::vector<size_t> &stack) {
+            visits[index] = Visit::Open;
+            stack.push_back(index);
+            for (size_t import : files[index].imports) {
+                if (visits[import] == Visit::Open) {
+                    stack.push_back(import);
+                    return true;
+                }
+                if (visits[import] == Visit::New && findCycle(files, import, visits, stack)) {
+                    return true;
+                }
+            }
+            stack.pop_back();
+            visits[index] = Visit::Done;
+            return false;
+        }
+
+        // What the arena of a merged configuration points into, it keeps the arena of every file alive.
+        struct MergedArenas {
+            std::vector<std::shared_ptr<Generic::Arena>> files;
+            Generic::Arena own;
+        };
+    }
+
+    ImportGraph::ImportGraph(const std::filesystem::path &path, std::vector<std::filesystem::path> searchPaths, bool parallel)
+        : searchPaths(std::move(searchPaths)) {
+        std::vector<std::filesystem::path> paths{std::filesystem::canonical(path)};
+        std::vector<std::optional<ConfigRoot>> roots;
+        std::vector<std::vector<size_t>> imports;
+        std::map<std::filesystem::path, size_t> indices{{paths[0], 0}};
+        auto parse = [&](size_t i) {
+            try {
+                roots[i].emplace(ConfigRoot::fromFile(paths[i]));
+            } catch (const std::runtime_error &error) {
+                throw std::runtime_error(std::format("In {}: {}", paths[i].string(), error.what()));
+            }
+        };
+
+        for (size_t begin = 0; begin < paths.size();) {
+            size_t end = paths.size();
+            roots.resize(end);
+            imports.resize(end);
+            if (parallel) {
+                Parallel::forEach(end - begin, [&](size_t i) { parse(begin + i); });
+            } else {
+                for (size_t i = begin; i < end; i++) {
+                    parse(i);
+                }
+            }
+            for (size_t i = begin; i < end; i++) {
+                for (const auto &import : roots[i]->imports) {
+                    auto [found, added] = indices.try_emplace(this->resolve(paths[i], import), paths.size());
+                    if (added) {
+                        paths.push_back(found->first);
+                    }
+                    imports[i].push_back(found->second);
+                }
+            }
+            begin = end;
+        }
+
+        this->nodes.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            this->nodes.push_back({std::move(paths[i]), std::move(*roots[i]), std::move(imports[i])});
+        }
+        this->checkCycles();
+    }
+
+    ConfigRoot ImportGraph::merged() const {
+        auto arenas = std::make_shared<MergedArenas>();
+        std::shared_ptr<Generic::Arena> arena(arenas, &arenas->own);
+        Generic::Allocator alloc(arena.get());
+        ConfigRoot result(std::pmr::string(this->nodes[0].root.name, alloc), std::pmr::vector<std::pmr::string>(alloc), std::pmr::vector<ConfigElement*>(alloc), std::pmr::vector<ConfigList*>(alloc));
+        result.arena = std::move(arena);
+
+        for (size_t index : this->mergeOrder()) {
+            const File &file = this->nodes[index];
+            arenas->files.push_back(file.root.arena);
+            result.elements.insert(result.elements.end(), file.root.elements.begin(), file.root.elements.end());
+            result.lists.insert(result.lists.end(), file.root.lists.begin(), file.root.lists.end());
+        }
+        return result;
+    }
+
+    // A topological order of the imports, every file before the ones it imports. Among the files that are ready at
+    // the same time, the one a depth-first walk of the imports as written reaches first goes first.
+    std::vector<size_t> ImportGraph::mergeOrder() const {
+        std::vector<size_t> rank(this->nodes.size(), SIZE_MAX);
+        std::vector<size_t> byRank;
+        std::vector<size_t> pending{0};
+        while (!pending.empty()) {
+            size_t index = pending.back();
+            pending.pop_back();
+            if (rank[index] != SIZE_MAX) {
+                continue;
+            }
+            rank[index] = byRank.size();
+            byRank.push_back(index);
+            // Pushed backwards so the first import is walked first.
+            pending.insert(pending.end(), this->nodes[index].imports.rbegin(), this->nodes[index].imports.rend());
+        }
+
+        std::vector<size_t> importers(this->nodes.size());
+        for (const auto &file : this->nodes) {
+            for (size_t import : file.imports) {
+                importers[import]++;
+            }
+        }
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<>> ready;
+        ready.push(rank[0]);
+        std::vector<size_t> order;
+        while (!ready.empty()) {
+            size_t index = byRank[ready.top()];
+            ready.pop();
+            order.push_back(index);
+            for (size_t import : this->nodes[index].imports) {
+                if (--importers[import] == 0) {
+                    ready.push(rank[import]);
+                }
+            }
+        }
+        return order;
+    }
+
+    std::filesystem::path ImportGraph::resolve(const std::filesystem::path &importer, std::string_view import) const {
+        std::filesystem::path name(import);
+        std::vector<std::filesystem::path> directories{importer.parent_path()};
+        directories.insert(directories.end(), this->searchPaths.begin(), this->searchPaths.end());
+        for (const auto &directory : directories) {
+            std::filesystem::path candidate = directory / name;
+            std::error_code error;
+            if (std::filesystem::is_regular_file(candidate, error)) {
+                return std::filesystem::canonical(candidate);
+            }
+            if (!name.has_extension()) {
+                candidate += ".plcl";
+                if (std::filesystem::is_regular_file(candidate, error)) {
+                    return std::filesystem::canonical(candidate);
+                }
+            }
+        }
+        throw std::runtime_error(std::format("Can't find import \"{}\" of {}", import, importer.string()));
+    }
+
+    void ImportGraph::checkCycles() const {
+        std::vector<Visit> visits(this->nodes.size(), Visit::New);
+        std::vector<size_t> stack;
+        for (size_t i = 0; i < this->nodes.size(); i++) {
+            if (visits[i] != Visit::New || !findCycle(this->nodes, i, visits, stack)) {
+                continue;
+            }
+            // The stack ends with the file that closes the cycle, the cycle starts where it was first opened.
+            size_t start = 0;
+            while (stack[start] != stack.back()) {
+                start++;
+            }
+            std::string message = "Import cycle:";
+            for (size_t j = start; j < stack.size(); j++) {
+                message += std::format("{} {}", j == start ? "" : " ->", this->nodes[stack[j]].path.string());
+            }
+            throw std::runtime_error(message);
+        }
+    }
+}
@@ -1,8 +1,164 @@
 // SPDX-License-Identifier: Apache-2.0
 
-#include <Lexer.hpp>
-#include <Generic.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <system_error>
 #include <utility>
+#include <Lexer.hpp>
+#include <Parallel.hpp>
+#include <Scanner.hpp>
+
+namespace {
+    using TokenType = PLCL::Lexer::TokenType;
+
+    struct Keyword {
+        std::string_view name;
+        TokenType type;
+    };
+
+    constexpr std::array keywords = {
+        Keyword{"true", TokenType::BooleanLiteral},
+        Keyword{"false", TokenType::BooleanLiteral},
+        Keyword{"import", TokenType::Import},
+        Keyword{"string", TokenType::String},
+        Keyword{"int", TokenType::Integer},
+        Keyword{"float", TokenType::Float},
+        Keyword{"bool", TokenType::Boolean},
+        Keyword{"configname", TokenType::ConfigName},
+        Keyword{"configelement", TokenType::ConfigElement},
+        Keyword{"endconfigelement", TokenType::EndConfigElement},
+        Keyword{"configlistelement", TokenType::ConfigListElement},
+        Keyword{"endconfiglistelement", TokenType::EndConfigListElement},
+        Keyword{"configlist", TokenType::ConfigList},
+        Keyword{"endconfiglist", TokenType::EndConfigList},
+        Keyword{"templatename", TokenType::TemplateName},
+        Keyword{"templateelement", TokenType::TemplateElement},
+        Keyword{"endtemplateelement", TokenType::EndTemplateElement},
+        Keyword{"templatelistelement", TokenType::TemplateListElement},
+        Keyword{"endtemplatelistelement", TokenType::EndTemplateListElement},
+        Keyword{"templatelist", TokenType::TemplateList},
+        Keyword{"endtemplatelist", TokenType::EndTemplateList},
+        Keyword{"templateelementoptions", TokenType::TemplateElementOptions},
+        Keyword{"endtemplateelementoptions", TokenType::EndTemplateElementOptions},
+        Keyword{"templatelistoptions", TokenType::TemplateListOptions},
+        Keyword{"endtemplatelistoptions", TokenType::EndTemplateListOptions},
+    };
+
+    // Keywords are all lowercase letters and identifiers only ever contain [A-Za-z0-9_], so setting bit 5 is enough
+    // to fold case: no digit or underscore folds onto a lowercase letter.
+    constexpr unsigned char fold(char c) {
+        return static_cast<unsigned char>(c) | 0x20;
+    }
+
+    constexpr size_t keywordTableSize = 64;
+
+    constexpr size_t keywordHash(std::string_view name, size_t seed) {
+        return ((fold(name.front()) * seed + fold(name.back())) * 31 + name.size()) % keywordTableSize;
+    }
+
+    // Searched at compile time, the first seed for which no two keywords share a slot.
+    constexpr size_t keywordSeed = [] {
+        for (size_t seed = 1; seed < 10000; seed++) {
+            std::array<bool, keywordTableSize> used = {};
+            bool collision = false;
+            for (const auto &keyword : keywords) {
+                size_t slot = keywordHash(keyword.name, seed);
+                collision = collision || used[slot];
+                used[slot] = true;
+            }
+            if (!collision) {
+                return seed;
+            }
+        }
+        return size_t{0};
+    }();
+    static_assert(keywordSeed != 0, "No perfect hash seed for the keyword table");
+
+    constexpr auto keywordTable = [] {
+        std::array<int8_t, keywordTableSize> table = {};
+        table.fill(-1);
+        for (size_t i = 0; i < keywords.size(); i++) {
+            table[keywordHash(keywords[i].name, keywordSeed)] = static_cast<int8_t>(i);
+        }
+        return table;
+    }();
+
+    constexpr auto keywordLengths = [] {
+        std::pair<size_t, size_t> lengths = {keywords[0].name.size(), keywords[0].name.size()};
+        for (const auto &keyword : keywords) {
+            lengths.first = std::min(lengths.first, keyword.name.size());
+            lengths.second = std::max(lengths.second, keyword.name.size());
+        }
+        return lengths;
+    }();
+
+    const Keyword *findKeyword(std::string_view value) {
+        if (value.size() < keywordLengths.first || value.size() > keywordLengths.second) {
+            return nullptr;
+        }
+        int8_t index = keywordTable[keywordHash(value, keywordSeed)];
+        if (index < 0) {
+            return nullptr;
+        }
+        const Keyword &keyword = keywords[index];
+        if (keyword.name.size() != value.size()) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < value.size(); i++) {
+            if (fold(value[i]) != static_cast<unsigned char>(keyword.name[i])) {
+                return nullptr;
+            }
+        }
+        return &keyword;
+    }
+
+    template<typename String>
+    String decode(std::string_view value, bool escaped, String result) {
+        if (!escaped) {
+            result = value;
+            return result;
+        }
+        result.reserve(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+            if (value[i] == '\\' && i + 1 < value.size() && value[i + 1] == '"') {
+                i++;
+            }
+            result += value[i];
+        }
+        return result;
+    }
+
+    // What matters for splitting the input: a newline is a safe place to cut unless it's inside a string literal.
+    // Comments always end at a newline, so a chunk never starts inside one.
+    enum class SplitState {
+        Code,
+        String
+    };
+
+    // Replays the lexer's string and comment rules over input[begin, end), which must end right after a newline.
+    SplitState scanSplitState(std::string_view input, size_t begin, size_t end, SplitState state) {
+        for (size_t i = begin; i < end; i++) {
+            char c = input[i];
+            if (state == SplitState::String) {
+                if (c == '"') {
+                    state = SplitState::Code;
+                } else if (c == '\\' && i + 1 < input.size() && input[i + 1] == '"') {
+                    i++;
+                }
+            } else if (c == '"') {
+                state = SplitState::String;
+            } else if (c == ';') {
+                i = std::min(input.find('\n', i), end);
+            }
+        }
+        return state;
+    }
+}
 
 namespace PLCL {
     std::string Lexer::tokenTypeToString(Lexer::TokenType type) {
@@ -72,21 +228,136 @@ namespace PLCL {
         }
     }
 
-    std::vector<Lexer::Token> Lexer::lex() {
+    std::string Lexer::Token::unescaped() const {
+        return decode(this->value, this->escaped, std::string());
+    }
+
+    std::pmr::string Lexer::Token::unescaped(const std::pmr::polymorphic_allocator<> &alloc) const {
+        return decode(this->value, this->escaped, std::pmr::string(alloc));
+    }
+
+    std::vector<Lexer::Token> Lexer::lex(bool parallel) {
+        if (parallel && this->index == 0 && this->input.size() >= parallelThreshold && Parallel::threadCount() > 1) {
+            return this->lexParallel();
+        }
         std::vector<Token> tokens;
-        while (!this->eof()) {
-            this->skipWhitespace();
-            this->skipComment();
-            this->skipWhitespace();
-            if (this->eof()) {
+        do {
+            tokens.push_back(this->pull());
+        } while (tokens.back().type != TokenType::EndOfFile);
+        return tokens;
+    }
+
+    std::vector<Lexer::Token> Lexer::lexParallel() {
+        // Candidate cut points are the starts of lines, a few per thread so uneven chunks balance out.
+        size_t segmentCount = Parallel::threadCount() * 4;
+        std::vector<size_t> bounds = {0};
+        for (size_t i = 1; i < segmentCount; i++) {
+            size_t newline = this->input.find('\n', std::max(this->input.size() / segmentCount * i, bounds.back()));
+            if (newline == std::string_view::npos || newline + 1 >= this->input.size()) {
                 break;
             }
-            tokens.push_back(this->nextToken());
+            bounds.push_back(newline + 1);
+        }
+        bounds.push_back(this->input.size());
+
+        // Whether a candidate is inside a string depends on everything before it. Every segment is scanned for both
+        // possible starting states at once, then the real states are chained through in order.
+        size_t segments = bounds.size() - 1;
+        std::vector<std::array<SplitState, 2>> transitions(segments);
+        Parallel::forEach(segments, [&](size_t i) {
+            transitions[i][0] = scanSplitState(this->input, bounds[i], bounds[i + 1], SplitState::Code);
+            transitions[i][1] = scanSplitState(this->input, bounds[i], bounds[i + 1], SplitState::String);
+        });
+        std::vector<size_t> cuts = {0};
+        SplitState state = SplitState::Code;
+        for (size_t i = 0; i < segments; i++) {
+            state = transitions[i][state == SplitState::String];
+            if (state == SplitState::Code && i + 1 < segments) {
+                cuts.push_back(bounds[i + 1]);
+            }
+        }
+        cuts.push_back(this->input.size());
+
+        struct Chunk {
+            std::vector<Token> tokens;
+            size_t lines;
+            size_t column;
+        };
+        std::vector<Chunk> chunks(cuts.size() - 1);
+        try {
+            Parallel::forEach(chunks.size(), [&](size_t i) {
+                Lexer lexer(this->input.substr(cuts[i], cuts[i + 1] - cuts[i]));
+                chunks[i].tokens = lexer.lex();
+                if (i + 1 < chunks.size()) {
+                    chunks[i].tokens.pop_back();
+                }
+                chunks[i].lines = lexer.line - 1;
+                chunks[i].column = lexer.column;
+            });
+        } catch (const std::runtime_error &) {
+            // Lexing errors are rare, lexing serially reports them with the right position.
+            return this->lex(false);
+        }
+
+        // Every chunk starts at the beginning of a line, so only the line numbers and offsets need fixing up.
+        std::vector<size_t> lineOffsets(chunks.size());
+        std::vector<size_t> tokenOffsets(chunks.size());
+        for (size_t i = 1; i < chunks.size(); i++) {
+            lineOffsets[i] = lineOffsets[i - 1] + chunks[i - 1].lines;
+            tokenOffsets[i] = tokenOffsets[i - 1] + chunks[i - 1].tokens.size();
         }
-        tokens.push_back({TokenType::EndOfFile, "", line, column});
+        std::vector<Token> tokens(tokenOffsets.back() + chunks.back().tokens.size());
+        Parallel::forEach(chunks.size(), [&](size_t i) {
+            auto out = tokens.begin() + static_cast<ptrdiff_t>(tokenOffsets[i]);
+            for (const Token &token : chunks[i].tokens) {
+                *out = token;
+                out->line += lineOffsets[i];
+                out->offset += cuts[i];
+                ++out;
+            }
+        });
+
+        this->index = this->input.size();
+        this->line = lineOffsets.back() + chunks.back().lines + 1;
+        this->column = chunks.back().column;
         return tokens;
     }
 
+    Lexer::Token Lexer::pull() {
+        this->skipWhitespace();
+        while (this->peek() == ';') {
+            this->skipComment();
+            this->skipWhitespace();
+        }
+        size_t start = this->index;
+        Token token = this->eof() ? Token{TokenType::EndOfFile, "", line, column} : this->nextToken();
+        token.offset = start;
+        return token;
+    }
+
+    Lexer::TokenStream::TokenStream(Lexer &lexer) : lexer(&lexer), current(lexer.pull()) {}
+
+    Lexer::TokenStream::TokenStream(const std::vector<Token> &tokens) : tokens(&tokens), current(tokens.at(0)) {}
+
+    void Lexer::TokenStream::advance() {
+        if (this->current.type == TokenType::EndOfFile) {
+            return;
+        }
+        if (this->lexer != nullptr) {
+            this->current = this->lexer->pull();
+        } else {
+            this->index++;
+            this->current = this->index < this->tokens->size() ? (*this->tokens)[this->index] : this->tokens->back();
+        }
+    }
+
+    size_t Lexer::TokenStream::sizeHint() const {
+        if (this->lexer != nullptr) {
+            return this->lexer->input.size();
+        }
+        return this->tokens->size() * sizeof(Token);
+    }
+
     unsigned char Lexer::peek() {
         if (this->index >= this->input.size()) {
             return '\0';
@@ -110,17 +381,23 @@ namespace PLCL {
         return this->index >= this->input.size();
     }
 
-    void Lexer::skipWhitespace() {
-        while (std::isspace(this->peek())) {
-            this->next();
+    void Lexer::advance(const Scanner::Result &result) {
+        if (result.newlines != 0) {
+            this->line += result.newlines;
+            this->column = result.index - result.lineStart + 1;
+        } else {
+            this->column += result.index - this->index;
         }
+        this->index = result.index;
+    }
+
+    void Lexer::skipWhitespace() {
+        this->advance(Scanner::skipWhitespace(this->input, this->index));
     }
 
     void Lexer::skipComment() {
         if (this->peek() == ';') {
-            while (this->peek() != '\n') {
-                this->next();
-            }
+            this->advance({Scanner::findNewline(this->input, this->index)});
         }
     }
 
@@ -132,107 +409,83 @@ namespace PLCL {
         }
         if (c == '"') {
             this->next();
-            std::string value;
-            while (this->peek() != '"') {
-                if (this->peek() == '\\' && this->input[this->index + 1] == '"') {
+            size_t start = this->index;
+            bool escaped = false;
+            while (true) {
+                this->advance(Scanner::findQuoteOrBackslash(this->input, this->index));
+                if (this->eof() || this->peek() == '"') {
+                    break;
+                }
+                if (this->index + 1 < this->input.size() && this->input[this->index + 1] == '"') {
+                    escaped = true;
                     this->next();
                 }
-                value += static_cast<char>(this->next());
+                this->next();
             }
+            if (this->eof()) {
+                throw std::runtime_error(std::format("Unterminated string literal at line {}, column {}", line, column));
+            }
+            std::string_view value = this->input.substr(start, this->index - start);
             this->next();
-            return {TokenType::StringLiteral, value, line, column};
+            return {TokenType::StringLiteral, value, line, column, escaped};
         }
         if (std::isdigit(c) || c == '-') {
-            std::string value;
-            while (std::isdigit(this->peek()) || this->peek() == '.') {
-                value += static_cast<char>(this->next());
-            }
-
-            return {TokenType::NumberLiteral, value, line, column};
+            return this->numberLiteral();
         }
         if (std::isalpha(c) || c == '_') {
-            std::string value;
+            size_t start = this->index;
             while (std::isalnum(this->peek()) || this->peek() == '_') {
-                value += static_cast<char>(this->next());
-            }
-            if (Generic::iequals(value, "true")) {
-                return {TokenType::BooleanLiteral, "true", line, column};
-            }
-            if (Generic::iequals(value, "false")) {
-                return {TokenType::BooleanLiteral, "false", line, column};
-            }
-            if (Generic::iequals(value, "import")) {
-                return {TokenType::Import, "", line, column};
-            }
-            if (Generic::iequals(value, "string")) {
-                return {TokenType::String, "", line, column};
-            }
-            if (Generic::iequals(value, "int")) {
-                return {TokenType::Integer, "", line, column};
-            }
-            if (Generic::iequals(value, "float")) {
-                return {TokenType::Float, "", line, column};
-            }
-            if (Generic::iequals(value, "bool")) {
-                return {TokenType::Boolean, "", line, column};
-            }
-            if (Generic::iequals(value, "configname")) {
-                return {TokenType::ConfigName, "", line, column};
-            }
-            if (Generic::iequals(value, "configelement")) {
-                return {TokenType::ConfigElement, "", line, column};
-            }
-            if (Generic::iequals(value, "endconfigelement")) {
-                return {TokenType::EndConfigElement, "", line, column};
-            }
-            if (Generic::iequals(value, "configlistelement")) {
-                return {TokenType::ConfigListElement, "", line, column};
-            }
-            if (Generic::iequals(value, "endconfiglistelement")) {
-                return {TokenType::EndConfigListElement, "", line, column};
-            }
-            if (Generic::iequals(value, "configlist")) {
-                return {TokenType::ConfigList, "", line, column};
-            }
-            if (Generic::iequals(value, "endconfiglist")) {
-                return {TokenType::EndConfigList, "", line, column};
-            }
-            if (Generic::iequals(value, "templatename")) {
-                return {TokenType::TemplateName, "", line, column};
-            }
-            if (Generic::iequals(value, "templateelement")) {
-                return {TokenType::TemplateElement, "", line, column};
-            }
-            if (Generic::iequals(value, "endtemplateelement")) {
-                return {TokenType::EndTemplateElement, "", line, column};
-            }
-            if (Generic::iequals(value, "templatelistelement")) {
-                return {TokenType::TemplateListElement, "", line, column};
-            }
-            if (Generic::iequals(value, "endtemplatelistelement")) {
-                return {TokenType::EndTemplateListElement, "", line, column};
-            }
-            if (Generic::iequals(value, "templatelist")) {
-                return {TokenType::TemplateList, "", line, column};
-            }
-            if (Generic::iequals(value, "endtemplatelist")) {
-                return {TokenType::EndTemplateList, "", line, column};
-            }
-            if (Generic::iequals(value, "templateelementoptions")) {
-                return {TokenType::TemplateElementOptions, "", line, column};
-            }
-            if (Generic::iequals(value, "endtemplateelementoptions")) {
-                return {TokenType::EndTemplateElementOptions, "", line, column};
-            }
-            if (Generic::iequals(value, "templatelistoptions")) {
-                return {TokenType::TemplateListOptions, "", line, column};
+                this->next();
             }
-            if (Generic::iequals(value, "endtemplatelistoptions")) {
-                return {TokenType::EndTemplateListOptions, "", line, column};
+            std::string_view value = this->input.substr(start, this->index - start);
+            if (const Keyword *keyword = findKeyword(value)) {
+                if (keyword->type == TokenType::BooleanLiteral) {
+                    return {TokenType::BooleanLiteral, keyword->name, line, column};
+                }
+                return {keyword->type, "", line, column};
             }
             return {TokenType::Name, value, line, column};
         }
         this->next();
-        return {TokenType::Unknown, std::string(1, static_cast<char>(c)), line, column};
+        return {TokenType::Unknown, this->input.substr(this->index - 1, 1), line, column};
+    }
+
+    // An optional minus, digits, and optionally a dot followed by more digits. The value is converted here, once, so
+    // the parsers never go back to the text.
+    Lexer::Token Lexer::numberLiteral() {
+        size_t start = this->index;
+        size_t startLine = this->line;
+        size_t startColumn = this->column;
+        if (this->peek() == '-') {
+            this->next();
+        }
+        while (std::isdigit(this->peek())) {
+            this->next();
+        }
+        bool isFloat = this->peek() == '.';
+        if (isFloat) {
+            this->next();
+            while (std::isdigit(this->peek())) {
+                this->next();
+            }
+        }
+        // Anything that could continue the number makes it malformed, like the second dot of `1.2.3`.
+        while (std::isdigit(this->peek()) || this->peek() == '.') {
+            this->next();
+        }
+        std::string_view value = this->input.substr(start, this->index - start);
+        Token token{TokenType::NumberLiteral, value, line, column};
+        token.isFloat = isFloat;
+        const char *end = value.data() + value.size();
+        std::from_chars_result result = isFloat
+            ? std::from_chars(value.data(), end, token.floatValue, std::chars_format::fixed)
+            : std::from_chars(value.data(), end, token.integerValue);
+        if (result.ec == std::errc::result_out_of_range) {
+            throw std::runtime_error(std::format("Number literal {} at line {}, column {} doesn't fit in a 64 bit {}", value, startLine, startColumn, isFloat ? "float" : "integer"));
+        }
+        if (result.ec != std::errc() || result.ptr != end) {
+            throw std::runtime_error(std::format("Malformed number literal {} at line {}, column {}", value, startLine, startColumn));
+        }
+        return token;
     }
 }
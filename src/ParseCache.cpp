@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <Binary.hpp>
+#include <ParseCache.hpp>
+#include <SourceFile.hpp>
+
+namespace PLCL {
+    namespace {
+        constexpr uint64_t prime1 = 0x9E3779B185EBCA87;
+        constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4F;
+        constexpr uint64_t prime3 = 0x165667B19E3779F9;
+
+        uint64_t load64(const char *data) {
+            uint64_t value;
+            std::memcpy(&value, data, sizeof(value));
+            if constexpr (std::endian::native == std::endian::big) {
+                value = std::byteswap(value);
+            }
+            return value;
+        }
+    }
+
+    ParseCache::ParseCache(std::filesystem::path directory) : directory(std::move(directory)) {
+        std::filesystem::create_directories(this->directory);
+    }
+
+    Config::ConfigRoot ParseCache::loadConfig(const std::filesystem::path &path) const {
+        return this->load<Config::ConfigRoot>(path, 'C');
+    }
+
+    Template::TemplateRoot ParseCache::loadTemplate(const std::filesystem::path &path) const {
+        return this->load<Template::TemplateRoot>(path, 'T');
+    }
+
+    // Folds the input 8 bytes at a time with the round and finalizer of xxHash64, it only has to tell files apart.
+    uint64_t ParseCache::hash(std::string_view data) {
+        uint64_t result = prime3 + data.size() * prime1;
+        size_t index = 0;
+        for (; index + 8 <= data.size(); index += 8) {
+            result ^= std::rotl(load64(data.data() + index) * prime2, 31) * prime1;
+            result = std::rotl(result, 27) * prime1 + prime2;
+        }
+        for (; index < data.size(); index++) {
+            result ^= static_cast<uint8_t>(data[index]) * prime3;
+            result = std::rotl(result, 11) * prime1;
+        }
+        result ^= result >> 33;
+        result *= prime2;
+        result ^= result >> 29;
+        result *= prime3;
+        result ^= result >> 32;
+        return result;
+    }
+
+    template <typename Root>
+    Root ParseCache::load(const std::filesystem::path &path, char kind) const {
+        SourceFile file(path);
+        std::filesystem::path entry = this->entry(file.view(), kind);
+        std::error_code error;
+        if (std::filesystem::exists(entry, error)) {
+            try {
+                return Root::fromBinaryFile(entry);
+            } catch (const std::runtime_error &) {
+                // Corrupt, or removed by another process in the meantime, either way the source is still there.
+                std::filesystem::remove(entry, error);
+            }
+        }
+        Lexer lexer(file.view());
+        Lexer::TokenStream tokens(lexer);
+        Root root(tokens);
+        this->store(entry, root.toBinary());
+        return root;
+    }
+
+    std::filesystem::path ParseCache::entry(std::string_view source, char kind) const {
+        return this->directory / std::format("{:016x}-{:x}-v{}.plcb{}", hash(source), source.size(), Binary::version, kind == 'C' ? 'c' : 't');
+    }
+
+    void ParseCache::store(const std::filesystem::path &entry, std::string_view data) const {
+        std::filesystem::path temporary = entry;
+        temporary += std::format(".{:08x}.tmp", std::random_device()());
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            out.close();
+            if (out.fail()) {
+                std::error_code error;
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary, entry, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+}
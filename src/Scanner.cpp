@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bit>
+#include <cstdint>
+#include <Scanner.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define PLCL_SCANNER_SSE2 1
+    #include <immintrin.h>
+    #if defined(__GNUC__)
+        #define PLCL_SCANNER_AVX2 1
+    #endif
+#endif
+
+namespace PLCL::Scanner {
+    namespace {
+        struct Kernels {
+            std::string_view name;
+            Result (*skipWhitespace)(std::string_view input, size_t index);
+            size_t (*findNewline)(std::string_view input, size_t index);
+            Result (*findQuoteOrBackslash)(std::string_view input, size_t index);
+        };
+
+        // Same set as std::isspace in the "C" locale.
+        bool isSpace(char c) {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        // Folds a bitmask of newline positions in the block starting at `base` into the result.
+        void countNewlines(Result &result, uint32_t newlines, size_t base) {
+            if (newlines != 0) {
+                result.newlines += std::popcount(newlines);
+                result.lineStart = base + std::bit_width(newlines);
+            }
+        }
+
+        void merge(Result &result, const Result &tail) {
+            result.index = tail.index;
+            result.newlines += tail.newlines;
+            if (tail.lineStart != Result::npos) {
+                result.lineStart = tail.lineStart;
+            }
+        }
+
+        uint32_t prefixMask(uint32_t length) {
+            return length >= 32 ? ~uint32_t{0} : (uint32_t{1} << length) - 1;
+        }
+
+        namespace scalar {
+            Result skipWhitespace(std::string_view input, size_t index) {
+                Result result{index};
+                while (result.index < input.size() && isSpace(input[result.index])) {
+                    if (input[result.index] == '\n') {
+                        result.newlines++;
+                        result.lineStart = result.index + 1;
+                    }
+                    result.index++;
+                }
+                return result;
+            }
+
+            size_t findNewline(std::string_view input, size_t index) {
+                size_t found = input.find('\n', index);
+                return found == std::string_view::npos ? input.size() : found;
+            }
+
+            Result findQuoteOrBackslash(std::string_view input, size_t index) {
+                Result result{index};
+                while (result.index < input.size() && input[result.index] != '"' && input[result.index] != '\\') {
+                    if (input[result.index] == '\n') {
+                        result.newlines++;
+                        result.lineStart = result.index + 1;
+                    }
+                    result.index++;
+                }
+                return result;
+            }
+
+            constexpr Kernels kernels = {"scalar", skipWhitespace, findNewline, findQuoteOrBackslash};
+        }
+
+#if PLCL_SCANNER_SSE2
+        namespace sse2 {
+            constexpr size_t width = 16;
+
+            __m128i load(const char *data) {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+            }
+
+            uint32_t mask(__m128i bytes) {
+                return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+            }
+
+            // '\t' through '\r' are shifted down to the bottom of the signed range, so one signed compare finds them.
+            uint32_t spaces(__m128i block) {
+                __m128i controls = _mm_cmplt_epi8(_mm_add_epi8(block, _mm_set1_epi8(0x77)), _mm_set1_epi8(-123));
+                return mask(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')), controls));
+            }
+
+            Result skipWhitespace(std::string_view input, size_t index) {
+                Result result{index};
+                while (result.index + width <= input.size()) {
+                    __m128i block = load(input.data() + result.index);
+                    uint32_t stop = ~spaces(block) & 0xFFFF;
+                    uint32_t skipped = stop == 0 ? width : std::countr_zero(stop);
+                    countNewlines(result, mask(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))) & prefixMask(skipped), result.index);
+                    result.index += skipped;
+                    if (stop != 0) {
+                        return result;
+                    }
+                }
+                merge(result, scalar::skipWhitespace(input, result.index));
+                return result;
+            }
+
+            size_t findNewline(std::string_view input, size_t index) {
+                while (index + width <= input.size()) {
+                    uint32_t found = mask(_mm_cmpeq_epi8(load(input.data() + index), _mm_set1_epi8('\n')));
+                    if (found != 0) {
+                        return index + std::countr_zero(found);
+                    }
+                    index += width;
+                }
+                return scalar::findNewline(input, index);
+            }
+
+            Result findQuoteOrBackslash(std::string_view input, size_t index) {
+                Result result{index};
+                while (result.index + width <= input.size()) {
+                    __m128i block = load(input.data() + result.index);
+                    uint32_t stop = mask(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))));
+                    uint32_t skipped = stop == 0 ? width : std::countr_zero(stop);
+                    countNewlines(result, mask(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))) & prefixMask(skipped), result.index);
+                    result.index += skipped;
+                    if (stop != 0) {
+                        return result;
+                    }
+                }
+                merge(result, scalar::findQuoteOrBackslash(input, result.index));
+                return result;
+            }
+
+            constexpr Kernels kernels = {"sse2", skipWhitespace, findNewline, findQuoteOrBackslash};
+        }
+#endif
+
+#if PLCL_SCANNER_AVX2
+        namespace avx2 {
+            constexpr size_t width = 32;
+
+            [[gnu::target("avx2")]] __m256i load(const char *data) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+            }
+
+            [[gnu::target("avx2")]] uint32_t mask(__m256i bytes) {
+                return static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+            }
+
+            // Same trick as the SSE2 version, AVX2 only has a signed greater-than so the operands are swapped.
+            [[gnu::target("avx2")]] uint32_t spaces(__m256i block) {
+                __m256i controls = _mm256_cmpgt_epi8(_mm256_set1_epi8(-123), _mm256_add_epi8(block, _mm256_set1_epi8(0x77)));
+                return mask(_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')), controls));
+            }
+
+            [[gnu::target("avx2")]] Result skipWhitespace(std::string_view input, size_t index) {
+                Result result{index};
+                while (result.index + width <= input.size()) {
+                    __m256i block = load(input.data() + result.index);
+                    uint32_t stop = ~spaces(block);
+                    uint32_t skipped = stop == 0 ? width : std::countr_zero(stop);
+                    countNewlines(result, mask(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))) & prefixMask(skipped), result.index);
+                    result.index += skipped;
+                    if (stop != 0) {
+                        return result;
+                    }
+                }
+                merge(result, sse2::skipWhitespace(input, result.index));
+                return result;
+            }
+
+            [[gnu::target("avx2")]] size_t findNewline(std::string_view input, size_t index) {
+                while (index + width <= input.size()) {
+                    uint32_t found = mask(_mm256_cmpeq_epi8(load(input.data() + index), _mm256_set1_epi8('\n')));
+                    if (found != 0) {
+                        return index + std::countr_zero(found);
+                    }
+                    index += width;
+                }
+                return sse2::findNewline(input, index);
+            }
+
+            [[gnu::target("avx2")]] Result findQuoteOrBackslash(std::string_view input, size_t index) {
+                Result result{index};
+                while (result.index + width <= input.size()) {
+                    __m256i block = load(input.data() + result.index);
+                    uint32_t stop = mask(_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'))));
+                    uint32_t skipped = stop == 0 ? width : std::countr_zero(stop);
+                    countNewlines(result, mask(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))) & prefixMask(skipped), result.index);
+                    result.index += skipped;
+                    if (stop != 0) {
+                        return result;
+                    }
+                }
+                merge(result, sse2::findQuoteOrBackslash(input, result.index));
+                return result;
+            }
+
+            constexpr Kernels kernels = {"avx2", skipWhitespace, findNewline, findQuoteOrBackslash};
+        }
+#endif
+
+        const Kernels &select() {
+#if PLCL_SCANNER_AVX2
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return avx2::kernels;
+            }
+#endif
+#if PLCL_SCANNER_SSE2
+            return sse2::kernels;
+#else
+            return scalar::kernels;
+#endif
+        }
+
+        const Kernels &kernels() {
+            static const Kernels &selected = select();
+            return selected;
+        }
+    }
+
+    Result skipWhitespace(std::string_view input, size_t index) {
+        return kernels().skipWhitespace(input, index);
+    }
+
+    size_t findNewline(std::string_view input, size_t index) {
+        return kernels().findNewline(input, index);
+    }
+
+    Result findQuoteOrBackslash(std::string_view input, size_t index) {
+        return kernels().findQuoteOrBackslash(input, index);
+    }
+
+    std::string_view implementation() {
+        return kernels().name;
+    }
+}
@@ -0,0 +1,411 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <vector>
+#include <Parallel.hpp>
+#include <Serializer.hpp>
+
+#if __has_include(<unistd.h>) && __has_include(<sys/uio.h>)
+    #define PLCL_SERIALIZER_POSIX 1
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+namespace PLCL {
+    namespace {
+        constexpr std::string_view spaceRun = "                                                                ";
+
+        // Large enough for any 64 bit integer, and for the shortest representation of any double.
+        using NumberBuffer = std::array<char, 32>;
+
+        template <typename T>
+        std::string_view toChars(NumberBuffer &buffer, T value) {
+            auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+            return {buffer.data(), static_cast<size_t>(end - buffer.data())};
+        }
+
+        std::string_view optionsName(Template::OptionsType optionsType) {
+            return optionsType == Template::OptionsType::Element ? "Element" : "List";
+        }
+    }
+
+    void FileSink::write(std::string_view data) {
+#if PLCL_SERIALIZER_POSIX
+        while (!data.empty()) {
+            ssize_t written = ::write(this->fd, data.data(), data.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::format("Couldn't write to file descriptor {}: {}", this->fd, std::strerror(errno)));
+            }
+            data.remove_prefix(static_cast<size_t>(written));
+        }
+#else
+        throw std::runtime_error("Writing to file descriptors isn't supported on this platform");
+#endif
+    }
+
+    void FileSink::writeAll(std::span<const std::string_view> pieces) {
+#if PLCL_SERIALIZER_POSIX
+        std::vector<iovec> vectors;
+        vectors.reserve(pieces.size());
+        for (std::string_view piece : pieces) {
+            if (!piece.empty()) {
+                vectors.push_back({const_cast<char *>(piece.data()), piece.size()});
+            }
+        }
+        size_t first = 0;
+        while (first < vectors.size()) {
+            auto count = static_cast<int>(std::min<size_t>(vectors.size() - first, IOV_MAX));
+            ssize_t written = ::writev(this->fd, vectors.data() + first, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::format("Couldn't write to file descriptor {}: {}", this->fd, std::strerror(errno)));
+            }
+            // Skip what was written, the first piece that was only partly written is resumed where it stopped.
+            auto left = static_cast<size_t>(written);
+            while (first < vectors.size() && left >= vectors[first].iov_len) {
+                left -= vectors[first].iov_len;
+                first++;
+            }
+            if (left != 0) {
+                vectors[first].iov_base = static_cast<char *>(vectors[first].iov_base) + left;
+                vectors[first].iov_len -= left;
+            }
+        }
+#else
+        Sink::writeAll(pieces);
+#endif
+    }
+
+    Serializer::Serializer(Sink &sink, size_t indent) : sink(sink), indent(indent) {}
+
+    void Serializer::write(const Config::ConfigRoot &root, bool parallel) {
+        if (!parallel) {
+            this->node(root);
+            this->flush();
+            return;
+        }
+
+        // Every task is a run of consecutive lines of the output, so the outputs only have to be joined in order.
+        struct Task {
+            enum class Kind {
+                Header,
+                Elements,
+                ListHeader,
+                ListChunk,
+                ListFooter,
+            };
+
+            Kind kind;
+            const Config::ConfigList *list;
+            size_t begin;
+            size_t end;
+        };
+        std::vector<Task> tasks{{Task::Kind::Header, nullptr, 0, 0}};
+        for (size_t begin = 0; begin < root.elements.size(); begin += chunkSize) {
+            tasks.push_back({Task::Kind::Elements, nullptr, begin, std::min(begin + chunkSize, root.elements.size())});
+        }
+        for (const auto *list : root.lists) {
+            tasks.push_back({Task::Kind::ListHeader, list, 0, 0});
+            for (size_t begin = 0; begin < list->elements.size(); begin += chunkSize) {
+                tasks.push_back({Task::Kind::ListChunk, list, begin, std::min(begin + chunkSize, list->elements.size())});
+            }
+            tasks.push_back({Task::Kind::ListFooter, list, 0, 0});
+        }
+
+        std::vector<std::string> outputs(tasks.size());
+        Parallel::forEach(tasks.size(), [&](size_t i) {
+            const Task &task = tasks[i];
+            StringSink sink(outputs[i]);
+            Serializer serializer(sink, this->indent);
+            switch (task.kind) {
+                case Task::Kind::Header:
+                    serializer.header(root);
+                    break;
+                case Task::Kind::Elements:
+                    for (size_t j = task.begin; j < task.end; j++) {
+                        serializer.node(*root.elements[j], 0);
+                    }
+                    break;
+                case Task::Kind::ListHeader:
+                    serializer.line(0, "ConfigList", task.list->type);
+                    break;
+                case Task::Kind::ListChunk:
+                    for (size_t j = task.begin; j < task.end; j++) {
+                        serializer.node(*task.list->elements[j], this->indent);
+                    }
+                    break;
+                case Task::Kind::ListFooter:
+                    serializer.append("endConfigList\n");
+                    break;
+            }
+            serializer.flush();
+        });
+
+        this->flush();
+        std::vector<std::string_view> pieces(outputs.begin(), outputs.end());
+        this->sink.writeAll(pieces);
+    }
+
+    void Serializer::write(const Config::ConfigList &list, size_t indentStart) {
+        this->node(list, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Config::ConfigListElement &listElement, size_t indentStart) {
+        this->node(listElement, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Config::ConfigElement &element, size_t indentStart) {
+        this->node(element, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Config::ConfigElementAttribute &attribute, size_t indentStart) {
+        this->node(attribute, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateRoot &root) {
+        this->node(root);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateList &list, size_t indentStart) {
+        this->node(list, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateListElement &listElement, size_t indentStart) {
+        this->node(listElement, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateElement &element, size_t indentStart) {
+        this->node(element, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateAttribute &attribute, size_t indentStart) {
+        this->node(attribute, indentStart);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateOptions &options, size_t indentStart, Template::OptionsType optionsType) {
+        this->node(options, indentStart, optionsType);
+        this->flush();
+    }
+
+    void Serializer::write(const Template::TemplateOption &option, size_t indentStart) {
+        this->node(option, indentStart);
+        this->flush();
+    }
+
+    void Serializer::header(const Config::ConfigRoot &root) {
+        this->line(0, "ConfigName", root.name);
+        for (const auto &import : root.imports) {
+            this->append("Import \"");
+            this->append(import);
+            this->append("\"\n");
+        }
+    }
+
+    void Serializer::node(const Config::ConfigRoot &root) {
+        this->header(root);
+        for (const auto *element : root.elements) {
+            this->node(*element, 0);
+        }
+        for (const auto *list : root.lists) {
+            this->node(*list, 0);
+        }
+    }
+
+    void Serializer::node(const Config::ConfigList &list, size_t indentStart) {
+        this->line(indentStart, "ConfigList", list.type);
+        for (const auto *listElement : list.elements) {
+            this->node(*listElement, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endConfigList\n");
+    }
+
+    void Serializer::node(const Config::ConfigListElement &listElement, size_t indentStart) {
+        NumberBuffer number;
+        this->line(indentStart, "ConfigListElement", toChars(number, listElement.id));
+        if (listElement.element != nullptr) {
+            this->node(*listElement.element, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endConfigListElement\n");
+    }
+
+    void Serializer::node(const Config::ConfigElement &element, size_t indentStart) {
+        this->line(indentStart, "ConfigElement", element.type);
+        for (const auto *attribute : element.attributes) {
+            this->node(*attribute, indentStart + this->indent);
+        }
+        for (const auto *list : element.lists) {
+            this->node(*list, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endConfigElement\n");
+    }
+
+    void Serializer::node(const Config::ConfigElementAttribute &attribute, size_t indentStart) {
+        this->spaces(indentStart);
+        this->append(attribute.name);
+        this->append(" = ");
+        this->value(attribute.value);
+    }
+
+    void Serializer::node(const Template::TemplateRoot &root) {
+        this->line(0, "TemplateName", root.name);
+        for (const auto *element : root.elements) {
+            this->node(*element, 0);
+        }
+        for (const auto *list : root.lists) {
+            this->node(*list, 0);
+        }
+    }
+
+    void Serializer::node(const Template::TemplateList &list, size_t indentStart) {
+        this->line(indentStart, "TemplateList", list.type);
+        if (list.options != nullptr) {
+            this->node(*list.options, indentStart + this->indent, Template::OptionsType::List);
+        }
+        for (const auto *listElement : list.elements) {
+            this->node(*listElement, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endTemplateList\n");
+    }
+
+    void Serializer::node(const Template::TemplateListElement &listElement, size_t indentStart) {
+        NumberBuffer number;
+        this->line(indentStart, "TemplateListElement", toChars(number, listElement.id));
+        if (listElement.element != nullptr) {
+            this->node(*listElement.element, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endTemplateListElement\n");
+    }
+
+    void Serializer::node(const Template::TemplateElement &element, size_t indentStart) {
+        this->line(indentStart, "TemplateElement", element.type);
+        if (element.options != nullptr) {
+            this->node(*element.options, indentStart + this->indent, Template::OptionsType::Element);
+        }
+        for (const auto *attribute : element.attributes) {
+            this->node(*attribute, indentStart + this->indent);
+        }
+        for (const auto *list : element.lists) {
+            this->node(*list, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endTemplateElement\n");
+    }
+
+    void Serializer::node(const Template::TemplateAttribute &attribute, size_t indentStart) {
+        this->spaces(indentStart);
+        this->append(Template::attributeTypeToString(attribute.type));
+        this->append(" ");
+        this->append(attribute.name);
+        if (attribute.required) {
+            this->append(" required");
+        }
+        if (attribute.defaultValue.has_value()) {
+            bool quoted = attribute.type == Template::AttributeType::String;
+            this->append(quoted ? " default \"" : " default ");
+            this->append(*attribute.defaultValue);
+            if (quoted) {
+                this->append("\"");
+            }
+        }
+        this->append("\n");
+    }
+
+    void Serializer::node(const Template::TemplateOptions &options, size_t indentStart, Template::OptionsType optionsType) {
+        this->spaces(indentStart);
+        this->append("Template");
+        this->append(optionsName(optionsType));
+        this->append("Options\n");
+        for (const auto *option : options.options) {
+            this->node(*option, indentStart + this->indent);
+        }
+        this->spaces(indentStart);
+        this->append("endTemplate");
+        this->append(optionsName(optionsType));
+        this->append("Options\n");
+    }
+
+    void Serializer::node(const Template::TemplateOption &option, size_t indentStart) {
+        this->spaces(indentStart);
+        this->append(option.name);
+        this->append(" = ");
+        this->value(option.value);
+    }
+
+    void Serializer::append(std::string_view text) {
+        if (this->buffer.size() + text.size() > bufferSize) {
+            this->flush();
+            if (text.size() > bufferSize) {
+                this->sink.write(text);
+                return;
+            }
+        }
+        this->buffer.append(text);
+    }
+
+    void Serializer::spaces(size_t count) {
+        for (; count > spaceRun.size(); count -= spaceRun.size()) {
+            this->append(spaceRun);
+        }
+        this->append(spaceRun.substr(0, count));
+    }
+
+    void Serializer::line(size_t indentStart, std::string_view keyword, std::string_view name) {
+        this->spaces(indentStart);
+        this->append(keyword);
+        this->append(" ");
+        this->append(name);
+        this->append("\n");
+    }
+
+    // Strings are written as they're stored, like `toString()` does. The shortest representation `std::to_chars`
+    // gives for floats is the one `std::format` uses too, so there are no trailing zeros.
+    void Serializer::value(const Generic::Value &value) {
+        NumberBuffer number;
+        if (auto string = Generic::get_if<std::string_view>(&value)) {
+            this->append("\"");
+            this->append(*string);
+            this->append("\"\n");
+        } else if (auto integer = Generic::get_if<int64_t>(&value)) {
+            this->append(toChars(number, *integer));
+            this->append("\n");
+        } else if (auto float64 = Generic::get_if<Generic::float64_t>(&value)) {
+            this->append(toChars(number, *float64));
+            this->append("\n");
+        } else if (auto boolean = Generic::get_if<bool>(&value)) {
+            this->append(*boolean ? "true\n" : "false\n");
+        }
+    }
+
+    void Serializer::flush() {
+        if (!this->buffer.empty()) {
+            this->sink.write(this->buffer);
+            this->buffer.clear();
+        }
+    }
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <utility>
+#include <SourceFile.hpp>
+
+#if __has_include(<sys/mman.h>)
+    #define PLCL_SOURCE_FILE_POSIX 1
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fstream>
+#endif
+
+namespace PLCL {
+    namespace {
+        std::runtime_error fileError(const std::filesystem::path &path, std::string_view what) {
+            return std::runtime_error(std::format("Couldn't {} {}: {}", what, path.string(), std::strerror(errno)));
+        }
+
+#if PLCL_SOURCE_FILE_POSIX
+        class Descriptor {
+        public:
+            explicit Descriptor(int fd) : fd(fd) {}
+            Descriptor(const Descriptor&) = delete;
+            Descriptor& operator=(const Descriptor&) = delete;
+            ~Descriptor() {
+                if (this->fd >= 0) {
+                    ::close(this->fd);
+                }
+            }
+
+            int fd;
+        };
+#endif
+    }
+
+#if PLCL_SOURCE_FILE_POSIX
+    SourceFile::SourceFile(const std::filesystem::path &path, bool map) {
+        Descriptor file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0) {
+            throw fileError(path, "open");
+        }
+        struct stat status = {};
+        if (::fstat(file.fd, &status) != 0) {
+            throw fileError(path, "stat");
+        }
+        this->size = static_cast<size_t>(status.st_size);
+        if (map && this->size >= mapThreshold) {
+            void *mapping = ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+            if (mapping == MAP_FAILED) {
+                throw fileError(path, "map");
+            }
+            ::madvise(mapping, this->size, MADV_SEQUENTIAL);
+            this->data = static_cast<const char *>(mapping);
+            this->mapped = true;
+            return;
+        }
+        this->buffer = std::make_unique_for_overwrite<char[]>(this->size);
+        size_t done = 0;
+        while (done < this->size) {
+            ssize_t count = ::read(file.fd, this->buffer.get() + done, this->size - done);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                throw fileError(path, "read");
+            }
+            if (count == 0) {
+                break; // The file shrank since fstat
+            }
+            done += static_cast<size_t>(count);
+        }
+        this->size = done;
+        this->data = this->buffer.get();
+    }
+
+    SourceFile::~SourceFile() {
+        if (this->mapped) {
+            ::munmap(const_cast<char *>(this->data), this->size);
+        }
+    }
+#else
+    SourceFile::SourceFile(const std::filesystem::path &path, bool) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw fileError(path, "open");
+        }
+        this->size = static_cast<size_t>(file.tellg());
+        this->buffer = std::make_unique_for_overwrite<char[]>(this->size);
+        file.seekg(0);
+        if (!file.read(this->buffer.get(), static_cast<std::streamsize>(this->size))) {
+            throw fileError(path, "read");
+        }
+        this->data = this->buffer.get();
+    }
+
+    SourceFile::~SourceFile() = default;
+#endif
+
+    SourceFile::SourceFile(SourceFile &&other) noexcept
+        : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), mapped(std::exchange(other.mapped, false)), buffer(std::move(other.buffer)) {}
+
+    SourceFile &SourceFile::operator=(SourceFile &&other) noexcept {
+        if (this != &other) {
+            SourceFile old(std::move(*this));
+            this->data = std::exchange(other.data, nullptr);
+            this->size = std::exchange(other.size, 0);
+            this->mapped = std::exchange(other.mapped, false);
+            this->buffer = std::move(other.buffer);
+        }
+        return *this;
+    }
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <Symbol.hpp>
+
+namespace PLCL {
+    struct Symbol::Table {
+        std::shared_mutex mutex;
+        // Holds the entries and their names, nothing is ever freed.
+        std::pmr::monotonic_buffer_resource arena;
+        std::unordered_map<std::string_view, const Entry *> names;
+    };
+
+    const Symbol::Entry Symbol::emptyEntry = {"", 0};
+
+    Symbol::Symbol() : entry(&emptyEntry) {}
+
+    Symbol::Symbol(std::string_view name) : entry(intern(name, true)) {}
+
+    std::optional<Symbol> Symbol::find(std::string_view name) {
+        if (const Entry *entry = intern(name, false)) {
+            return Symbol(entry);
+        }
+        return std::nullopt;
+    }
+
+    const Symbol::Entry *Symbol::intern(std::string_view name, bool add) {
+        if (name.empty()) {
+            return &emptyEntry;
+        }
+        // The names this thread has already looked up. Entries never move, so it never has to be invalidated.
+        thread_local std::unordered_map<std::string_view, const Entry *> seen;
+        if (auto found = seen.find(name); found != seen.end()) {
+            return found->second;
+        }
+
+        // Never destroyed, so symbols stay valid while other static objects are destroyed.
+        static Table *table = new Table();
+        const Entry *entry = nullptr;
+        {
+            std::shared_lock lock(table->mutex);
+            if (auto found = table->names.find(name); found != table->names.end()) {
+                entry = found->second;
+            }
+        }
+        if (entry == nullptr) {
+            if (!add) {
+                return nullptr;
+            }
+            std::unique_lock lock(table->mutex);
+            if (auto found = table->names.find(name); found != table->names.end()) {
+                entry = found->second;
+            } else {
+                if (table->names.size() == UINT32_MAX) {
+                    throw std::runtime_error("Too many distinct names to intern");
+                }
+                auto *text = static_cast<char *>(table->arena.allocate(name.size(), 1));
+                name.copy(text, name.size());
+                auto id = static_cast<uint32_t>(table->names.size() + 1);
+                entry = new (table->arena.allocate(sizeof(Entry), alignof(Entry))) Entry{std::string_view(text, name.size()), id};
+                table->names.emplace(entry->name, entry);
+            }
+        }
+        seen.emplace(entry->name, entry);
+        return entry;
+    }
+}
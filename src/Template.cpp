@@ -1,9 +1,14 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdint>
 #include <stdexcept>
 #include <format>
+#include <memory>
 #include <utility>
+#include <Binary.hpp>
+#include <Serializer.hpp>
 #include <Template.hpp>
+#include <SourceFile.hpp>
 
 namespace PLCL::Template {
     std::string attributeTypeToString(AttributeType type) {
@@ -21,187 +26,326 @@ namespace PLCL::Template {
         }
     }
 
-    [[maybe_unused]] TemplateRoot TemplateRoot::fromString(const std::string &input) {
+    [[maybe_unused]] TemplateRoot TemplateRoot::fromString(std::string_view input) {
         Lexer lexer(input);
-        auto tokens = lexer.lex();
+        Lexer::TokenStream tokens(lexer);
         return TemplateRoot(tokens);
     }
 
-    TemplateRoot::TemplateRoot(std::vector<Lexer::Token> &tokens) {
-        size_t index = 0;
-        if (tokens[index].type != Lexer::TokenType::TemplateName) {
-            throw Generic::genericExpectedError(R"("TemplateName")", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+    [[maybe_unused]] TemplateRoot TemplateRoot::fromFile(const std::filesystem::path &path) {
+        SourceFile file(path);
+        Lexer lexer(file.view());
+        Lexer::TokenStream tokens(lexer);
+        return TemplateRoot(tokens);
+    }
+
+    namespace {
+        enum AttributeFlags : uint8_t {
+            Required = 1,
+            HasDefault = 2,
+        };
+
+        void encode(Binary::Writer &out, const TemplateOptions *options) {
+            out.byte(options != nullptr);
+            if (options == nullptr) {
+                return;
+            }
+            out.varint(options->options.size());
+            for (const auto *option : options->options) {
+                out.string(option->name);
+                out.value(option->value);
+            }
+        }
+
+        void encode(Binary::Writer &out, const TemplateList &list);
+
+        void encode(Binary::Writer &out, const TemplateElement &element) {
+            out.string(element.type);
+            encode(out, element.options);
+            out.varint(element.attributes.size());
+            for (const auto *attribute : element.attributes) {
+                out.byte(static_cast<uint8_t>(attribute->type));
+                out.string(attribute->name);
+                out.byte((attribute->required ? Required : 0) | (attribute->defaultValue.has_value() ? HasDefault : 0));
+                if (attribute->defaultValue.has_value()) {
+                    out.string(*attribute->defaultValue);
+                }
+            }
+            out.varint(element.lists.size());
+            for (const auto *list : element.lists) {
+                encode(out, *list);
+            }
+        }
+
+        void encode(Binary::Writer &out, const TemplateList &list) {
+            out.string(list.type);
+            encode(out, list.options);
+            out.varint(list.elements.size());
+            for (const auto *listElement : list.elements) {
+                out.varint(listElement->id);
+                out.byte(listElement->element != nullptr);
+                if (listElement->element != nullptr) {
+                    encode(out, *listElement->element);
+                }
+            }
+        }
+
+        TemplateOptions *decodeOptions(Binary::Reader &in, Generic::Allocator alloc) {
+            if (in.byte() == 0) {
+                return nullptr;
+            }
+            auto *options = alloc.new_object<TemplateOptions>(std::pmr::vector<TemplateOption*>(in.count(), alloc));
+            for (auto &option : options->options) {
+                std::pmr::string name(in.string(), alloc);
+                option = alloc.new_object<TemplateOption>(std::move(name), in.value(alloc));
+            }
+            return options;
+        }
+
+        TemplateAttribute *decodeAttribute(Binary::Reader &in, Generic::Allocator alloc) {
+            uint8_t type = in.byte();
+            if (type > static_cast<uint8_t>(AttributeType::Boolean)) {
+                throw std::runtime_error(std::format("Invalid binary tree: unknown attribute type {}", type));
+            }
+            Symbol name(in.string());
+            uint8_t flags = in.byte();
+            std::optional<std::pmr::string> defaultValue;
+            if ((flags & HasDefault) != 0) {
+                defaultValue.emplace(in.string(), alloc);
+            }
+            return alloc.new_object<TemplateAttribute>(static_cast<AttributeType>(type), name, std::move(defaultValue), (flags & Required) != 0);
+        }
+
+        TemplateList *decodeList(Binary::Reader &in, Generic::Allocator alloc);
+
+        TemplateElement *decodeElement(Binary::Reader &in, Generic::Allocator alloc) {
+            Symbol type(in.string());
+            TemplateOptions *options = decodeOptions(in, alloc);
+            auto *element = alloc.new_object<TemplateElement>(type, options, std::pmr::vector<TemplateAttribute*>(alloc), std::pmr::vector<TemplateList*>(alloc));
+            element->attributes.resize(in.count());
+            for (auto &attribute : element->attributes) {
+                attribute = decodeAttribute(in, alloc);
+            }
+            element->lists.resize(in.count());
+            for (auto &list : element->lists) {
+                list = decodeList(in, alloc);
+            }
+            return element;
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+
+        TemplateList *decodeList(Binary::Reader &in, Generic::Allocator alloc) {
+            Symbol type(in.string());
+            TemplateOptions *options = decodeOptions(in, alloc);
+            auto *list = alloc.new_object<TemplateList>(type, options, std::pmr::vector<TemplateListElement*>(in.count(), alloc));
+            for (auto &listElement : list->elements) {
+                size_t id = in.varint();
+                listElement = alloc.new_object<TemplateListElement>(id, in.byte() != 0 ? decodeElement(in, alloc) : nullptr);
+            }
+            return list;
         }
-        this->name = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            switch (tokens[index].type) {
+    }
+
+    [[maybe_unused]] TemplateRoot TemplateRoot::fromBinary(std::string_view data) {
+        auto arena = std::make_shared<Generic::Arena>(data.size());
+        Generic::Allocator alloc(arena.get());
+        Binary::Reader in(data, 'T');
+        std::pmr::string name(in.string(), alloc);
+        std::pmr::vector<TemplateElement*> elements(in.count(), alloc);
+        for (auto &element : elements) {
+            element = decodeElement(in, alloc);
+        }
+        std::pmr::vector<TemplateList*> lists(in.count(), alloc);
+        for (auto &list : lists) {
+            list = decodeList(in, alloc);
+        }
+        in.finish();
+        TemplateRoot root(std::move(name), std::move(elements), std::move(lists));
+        root.arena = std::move(arena);
+        return root;
+    }
+
+    [[maybe_unused]] TemplateRoot TemplateRoot::fromBinaryFile(const std::filesystem::path &path) {
+        SourceFile file(path);
+        return fromBinary(file.view());
+    }
+
+    [[maybe_unused]] std::string TemplateRoot::toBinary() const {
+        Binary::Writer out('T');
+        out.string(this->name);
+        out.varint(this->elements.size());
+        for (const auto *element : this->elements) {
+            encode(out, *element);
+        }
+        out.varint(this->lists.size());
+        for (const auto *list : this->lists) {
+            encode(out, *list);
+        }
+        return out.finish();
+    }
+
+    TemplateRoot::TemplateRoot(Lexer::TokenStream &tokens)
+        : TemplateRoot(tokens, std::make_shared<Generic::Arena>(tokens.sizeHint())) {}
+
+    TemplateRoot::TemplateRoot(Lexer::TokenStream &tokens, std::shared_ptr<Generic::Arena> arena)
+        : arena(std::move(arena)), name(this->arena.get()), elements(this->arena.get()), lists(this->arena.get()) {
+        Generic::Allocator alloc(this->arena.get());
+        if (tokens.peek().type != Lexer::TokenType::TemplateName) {
+            throw Generic::genericExpectedError(R"("TemplateName")", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
+        }
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::Name) {
+            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
+        }
+        this->name = tokens.peek().value;
+        tokens.advance();
+        while (true) {
+            switch (tokens.peek().type) {
                 case Lexer::TokenType::TemplateElement:
-                    this->elements.push_back(new TemplateElement(tokens, index));
+                    this->elements.push_back(alloc.new_object<TemplateElement>(tokens, alloc));
                     break;
                 case Lexer::TokenType::TemplateList:
-                    this->lists.push_back(new TemplateList(tokens, index));
+                    this->lists.push_back(alloc.new_object<TemplateList>(tokens, alloc));
                     break;
                 case Lexer::TokenType::EndOfFile:
                     return;
                 [[unlikely]] default:
-                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens.peek().line, tokens.peek().column, Lexer::tokenTypeToString(tokens.peek().type)));
             }
         }
     }
 
     std::string TemplateRoot::toString(size_t indent) {
         std::string result;
-        result += std::format("TemplateName {}\n", this->name);
-        for (auto &element : this->elements) {
-            result += element->toString(indent, 0);
-        }
-        for (auto &list : this->lists) {
-            result += list->toString(indent, 0);
-        }
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this);
         return result;
     }
 
-    TemplateList::TemplateList(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::TemplateList) {
-            throw Generic::genericExpectedError(R"("TemplateList")", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+    TemplateList::TemplateList(Lexer::TokenStream &tokens, Generic::Allocator alloc)
+        : elements(alloc) {
+        if (tokens.peek().type != Lexer::TokenType::TemplateList) {
+            throw Generic::genericExpectedError(R"("TemplateList")", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             //throw std::runtime_error(std::format("Expected \"TemplateList\" at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::Name) {
+            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             //throw std::runtime_error(std::format("Expected Name at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
         }
-        this->type = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            switch (tokens[index].type) {
+        this->type = Symbol(tokens.peek().value);
+        tokens.advance();
+        while (true) {
+            switch (tokens.peek().type) {
                 case Lexer::TokenType::TemplateListElement:
-                    this->elements.push_back(new TemplateListElement(tokens, index));
+                    this->elements.push_back(alloc.new_object<TemplateListElement>(tokens, alloc));
                     break;
                 case Lexer::TokenType::TemplateListOptions:
                     if (this->options != nullptr) {
-                        throw std::runtime_error(std::format("TemplateListOptions already set, Unexpected TemplateListOptions at line {}, column {}", tokens[index].line, tokens[index].column));
+                        throw std::runtime_error(std::format("TemplateListOptions already set, Unexpected TemplateListOptions at line {}, column {}", tokens.peek().line, tokens.peek().column));
                     }
-                    this->options = new TemplateOptions(tokens, index);
+                    this->options = alloc.new_object<TemplateOptions>(tokens, alloc);
                     break;
                 case Lexer::TokenType::EndTemplateList:
-                    index++;
+                    tokens.advance();
                     return;
                 [[unlikely]] default:
-                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, got {}", tokens.peek().line, tokens.peek().column, Lexer::tokenTypeToString(tokens.peek().type)));
             }
         }
     }
 
     std::string TemplateList::toString(size_t indent, size_t indentStart) {
         std::string result;
-        result += std::format("{}TemplateList {}\n", std::string(indentStart, ' '), this->type);
-        if (this->options != nullptr) {
-            result += this->options->toString(indent, indentStart + indent, OptionsType::List);
-        }
-        for (auto &element : this->elements) {
-            result += element->toString(indent, indentStart + indent);
-        }
-        result += std::format("{}endTemplateList\n", std::string(indentStart, ' '));
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart);
         return result;
     }
 
-    TemplateListElement::TemplateListElement(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::TemplateListElement) {
-            throw Generic::genericExpectedError(R"("TemplateListElement")", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+    TemplateListElement::TemplateListElement(Lexer::TokenStream &tokens, Generic::Allocator alloc) {
+        if (tokens.peek().type != Lexer::TokenType::TemplateListElement) {
+            throw Generic::genericExpectedError(R"("TemplateListElement")", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             //throw std::runtime_error(std::format("Expected \"TemplateListElement\" at line {}, column {}, but got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::NumberLiteral) {
-            throw Generic::genericExpectedError("NumberLiteral", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::NumberLiteral) {
+            throw Generic::genericExpectedError("NumberLiteral", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             //throw std::runtime_error(std::format("Expected NumberLiteral at line {}, column {}, but got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
         }
-        this->id = std::stoll(tokens[index].value);
-        index++;
-        while (index < tokens.size()) {
-            switch (tokens[index].type) {
+        if (tokens.peek().isFloat || tokens.peek().integerValue < 0) {
+            throw Generic::genericExpectedError("a non-negative integer", tokens.peek().value, tokens.peek().line, tokens.peek().column);
+        }
+        this->id = static_cast<size_t>(tokens.peek().integerValue);
+        tokens.advance();
+        while (true) {
+            switch (tokens.peek().type) {
                 case Lexer::TokenType::TemplateElement:
-                    this->element = new TemplateElement(tokens, index);
+                    this->element = alloc.new_object<TemplateElement>(tokens, alloc);
                     //this->elements.push_back(new TemplateElement(tokens, index));
                     break;
                 case Lexer::TokenType::EndTemplateListElement:
-                    index++;
+                    tokens.advance();
                     return;
                 [[unlikely]] default:
-                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, but got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, but got {}", tokens.peek().line, tokens.peek().column, Lexer::tokenTypeToString(tokens.peek().type)));
             }
         }
     }
 
     std::string TemplateListElement::toString(size_t indent, size_t indentStart) {
         std::string result;
-        result += std::format("{}TemplateListElement {}\n", std::string(indentStart, ' '), this->id);
-        result += this->element->toString(indent, indentStart + indent);
-        result += std::format("{}endTemplateListElement\n", std::string(indentStart, ' '));
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart);
         return result;
     }
 
-    TemplateElement::TemplateElement(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::TemplateElement) {
-            throw Generic::genericExpectedError(R"("TemplateElement")", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+    TemplateElement::TemplateElement(Lexer::TokenStream &tokens, Generic::Allocator alloc)
+        : attributes(alloc), lists(alloc) {
+        if (tokens.peek().type != Lexer::TokenType::TemplateElement) {
+            throw Generic::genericExpectedError(R"("TemplateElement")", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             //throw std::runtime_error(std::format("Expected \"TemplateElement\" at line {}, column {}, but got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::Name) {
+            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             //throw std::runtime_error(std::format("Expected Name at line {}, column {}, but got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
         }
-        this->type = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            switch (tokens[index].type) {
+        this->type = Symbol(tokens.peek().value);
+        tokens.advance();
+        while (true) {
+            switch (tokens.peek().type) {
                 case Lexer::TokenType::String:
                 case Lexer::TokenType::Integer:
                 case Lexer::TokenType::Float:
                 case Lexer::TokenType::Boolean:
-                    this->attributes.push_back(new TemplateAttribute(tokens, index));
+                    this->attributes.push_back(alloc.new_object<TemplateAttribute>(tokens, alloc));
                     break;
                 case Lexer::TokenType::TemplateElementOptions:
                     if (this->options != nullptr) {
-                        throw std::runtime_error(std::format("TemplateElementOptions already set, Unexpected TemplateElementOptions at line {}, column {}", tokens[index].line, tokens[index].column));
+                        throw std::runtime_error(std::format("TemplateElementOptions already set, Unexpected TemplateElementOptions at line {}, column {}", tokens.peek().line, tokens.peek().column));
                     }
-                    this->options = new TemplateOptions(tokens, index);
+                    this->options = alloc.new_object<TemplateOptions>(tokens, alloc);
                     break;
                 case Lexer::TokenType::TemplateList:
-                    this->lists.push_back(new TemplateList(tokens, index));
+                    this->lists.push_back(alloc.new_object<TemplateList>(tokens, alloc));
                     break;
                 case Lexer::TokenType::EndTemplateElement:
-                    index++;
+                    tokens.advance();
                     return;
                 [[unlikely]] default:
-                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, but got {}", tokens[index].line, tokens[index].column, Lexer::tokenTypeToString(tokens[index].type)));
+                    throw std::runtime_error(std::format("Unexpected token at line {}, column {}, but got {}", tokens.peek().line, tokens.peek().column, Lexer::tokenTypeToString(tokens.peek().type)));
             }
         }
     }
 
     std::string TemplateElement::toString(size_t indent, size_t indentStart) {
         std::string result;
-        result += std::format("{}TemplateElement {}\n", std::string(indentStart, ' '), this->type);
-        if (this->options != nullptr) {
-            result += this->options->toString(indent, indentStart + indent, OptionsType::Element);
-        }
-        for (auto &attribute : this->attributes) {
-            result += attribute->toString(indentStart + indent);
-        }
-        for (auto &list : this->lists) {
-            result += list->toString(indent, indentStart + indent);
-        }
-        result += std::format("{}endTemplateElement\n", std::string(indentStart, ' '));
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart);
         return result;
     }
 
-    TemplateAttribute::TemplateAttribute(std::vector<Lexer::Token> &tokens, size_t &index) {
-        switch (tokens[index].type) {
+    TemplateAttribute::TemplateAttribute(Lexer::TokenStream &tokens, Generic::Allocator alloc) {
+        switch (tokens.peek().type) {
             case Lexer::TokenType::String:
                 this->type = AttributeType::String;
                 break;
@@ -215,45 +359,48 @@ namespace PLCL::Template {
                 this->type = AttributeType::Boolean;
                 break;
             [[unlikely]] default:
-                throw Generic::genericExpectedError("String, Integer, Float, or Boolean", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+                throw Generic::genericExpectedError("String, Integer, Float, or Boolean", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::Name) {
+            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
         }
-        this->name = tokens[index].value;
-        index++;
-        while (index < tokens.size()) {
-            if (tokens[index].type != Lexer::TokenType::Name) {
+        this->name = Symbol(tokens.peek().value);
+        tokens.advance();
+        while (true) {
+            if (tokens.peek().type != Lexer::TokenType::Name) {
                 return;
             }
-            if (tokens[index].value == "required") {
+            if (tokens.peek().value == "required") {
                 this->required = true;
-                index++;
-            } else if (tokens[index].value == "default") {
-                index++;
+                tokens.advance();
+            } else if (tokens.peek().value == "default") {
+                tokens.advance();
                 switch (this->type) {
                     case AttributeType::String:
-                        if (tokens[index].type != Lexer::TokenType::StringLiteral) {
-                            throw Generic::genericExpectedError("StringLiteral", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+                        if (tokens.peek().type != Lexer::TokenType::StringLiteral) {
+                            throw Generic::genericExpectedError("StringLiteral", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
                         }
-                        this->defaultValue = new std::string(tokens[index].value);
+                        this->defaultValue = tokens.peek().unescaped(alloc);
                         break;
                     case AttributeType::Integer:
                     case AttributeType::Float:
-                        if (tokens[index].type != Lexer::TokenType::NumberLiteral) {
-                            throw Generic::genericExpectedError("NumberLiteral", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+                        if (tokens.peek().type != Lexer::TokenType::NumberLiteral) {
+                            throw Generic::genericExpectedError("NumberLiteral", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
+                        }
+                        if (this->type == AttributeType::Integer && tokens.peek().isFloat) {
+                            throw Generic::genericExpectedError("an integer", tokens.peek().value, tokens.peek().line, tokens.peek().column);
                         }
-                        this->defaultValue = new std::string(tokens[index].value);
+                        this->defaultValue.emplace(tokens.peek().value, alloc);
                         break;
                     case AttributeType::Boolean:
-                        if (tokens[index].type != Lexer::TokenType::BooleanLiteral) {
-                            throw Generic::genericExpectedError("BooleanLiteral", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+                        if (tokens.peek().type != Lexer::TokenType::BooleanLiteral) {
+                            throw Generic::genericExpectedError("BooleanLiteral", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
                         }
-                        this->defaultValue = new std::string(tokens[index].value);
+                        this->defaultValue.emplace(tokens.peek().value, alloc);
                         break;
                 }
-                index++;
+                tokens.advance();
             } else {
                 return;
             }
@@ -262,86 +409,78 @@ namespace PLCL::Template {
 
     std::string TemplateAttribute::toString(size_t indent) {
         std::string result;
-        result += std::format("{}{} {}{}", std::string(indent, ' '), attributeTypeToString(this->type), this->name, this->required ? " required" : "");
-        if (this->defaultValue != nullptr) {
-            if (this->type == AttributeType::String) {
-                result += std::format(" default \"{}\"", *this->defaultValue);
-            } else {
-                result += std::format(" default {}", *this->defaultValue);
-            }
-        }
-        result += '\n';
+        StringSink sink(result);
+        Serializer(sink, 0).write(*this, indent);
         return result;
     }
 
-    TemplateOptions::TemplateOptions(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::TemplateElementOptions && tokens[index].type != Lexer::TokenType::TemplateListOptions) {
-            throw Generic::genericExpectedError(R"("TemplateElementOptions" or "TemplateListOptions")", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
-        }
-        index++;
-        while (index < tokens.size()) {
-            if (tokens[index].type == Lexer::TokenType::Name) {
-                this->options.push_back(new TemplateOption(tokens, index));
-            } else if (tokens[index].type == Lexer::TokenType::EndTemplateElementOptions || tokens[index].type == Lexer::TokenType::EndTemplateListOptions) {
-                index++;
+    TemplateOptions::TemplateOptions(Lexer::TokenStream &tokens, Generic::Allocator alloc)
+        : options(alloc) {
+        if (tokens.peek().type != Lexer::TokenType::TemplateElementOptions && tokens.peek().type != Lexer::TokenType::TemplateListOptions) {
+            throw Generic::genericExpectedError(R"("TemplateElementOptions" or "TemplateListOptions")", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
+        }
+        tokens.advance();
+        while (true) {
+            if (tokens.peek().type == Lexer::TokenType::Name) {
+                this->options.push_back(alloc.new_object<TemplateOption>(tokens, alloc));
+            } else if (tokens.peek().type == Lexer::TokenType::EndTemplateElementOptions || tokens.peek().type == Lexer::TokenType::EndTemplateListOptions) {
+                tokens.advance();
                 return;
             } else {
-                throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+                throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
             }
         }
     }
 
     std::string TemplateOptions::toString(size_t indent, size_t indentStart, PLCL::Template::OptionsType optionsType) {
         std::string result;
-        result += std::format("{}Template{}Options\n", std::string(indentStart, ' '), optionsType == OptionsType::Element ? "Element" : "List");
-        for (auto &option : this->options) {
-            result += option->toString(indentStart + indent);
-        }
-        result += std::format("{}endTemplate{}Options\n", std::string(indentStart, ' '), optionsType == OptionsType::Element ? "Element" : "List");
+        StringSink sink(result);
+        Serializer(sink, indent).write(*this, indentStart, optionsType);
         return result;
     }
 
-    TemplateOption::TemplateOption(std::vector<Lexer::Token> &tokens, size_t &index) {
-        if (tokens[index].type != Lexer::TokenType::Name) {
-            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+    TemplateOption::TemplateOption(Lexer::TokenStream &tokens, Generic::Allocator alloc)
+        : name(alloc) {
+        if (tokens.peek().type != Lexer::TokenType::Name) {
+            throw Generic::genericExpectedError("Name", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
         }
-        this->name = tokens[index].value;
-        index++;
-        if (tokens[index].type != Lexer::TokenType::Equals) {
-            throw Generic::genericExpectedError("=", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+        this->name = tokens.peek().value;
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::Equals) {
+            throw Generic::genericExpectedError("=", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
         }
-        index++;
-        if (tokens[index].type != Lexer::TokenType::StringLiteral && tokens[index].type != Lexer::TokenType::NumberLiteral && tokens[index].type != Lexer::TokenType::BooleanLiteral) {
-            throw Generic::genericExpectedError("StringLiteral, NumberLiteral, or BooleanLiteral", Lexer::tokenTypeToString(tokens[index].type), tokens[index].line, tokens[index].column);
+        tokens.advance();
+        if (tokens.peek().type != Lexer::TokenType::StringLiteral && tokens.peek().type != Lexer::TokenType::NumberLiteral && tokens.peek().type != Lexer::TokenType::BooleanLiteral) {
+            throw Generic::genericExpectedError("StringLiteral, NumberLiteral, or BooleanLiteral", Lexer::tokenTypeToString(tokens.peek().type), tokens.peek().line, tokens.peek().column);
         }
-        switch (tokens[index].type) {
+        switch (tokens.peek().type) {
             case Lexer::TokenType::StringLiteral:
-                this->value = tokens[index].value;
+                if (tokens.peek().escaped) {
+                    this->value = Generic::Value::copy(tokens.peek().unescaped(), alloc);
+                } else {
+                    this->value = Generic::Value::copy(tokens.peek().value, alloc);
+                }
                 break;
             case Lexer::TokenType::NumberLiteral:
-                this->value = std::stoll(tokens[index].value);
+                if (tokens.peek().isFloat) {
+                    this->value = tokens.peek().floatValue;
+                } else {
+                    this->value = tokens.peek().integerValue;
+                }
                 break;
             case Lexer::TokenType::BooleanLiteral:
-                this->value = tokens[index].value == "true";
+                this->value = tokens.peek().value == "true";
                 break;
             [[unlikely]] default:
                 std::unreachable();
         }
-        index++;
+        tokens.advance();
     }
 
     std::string TemplateOption::toString(size_t indent) {
         std::string result;
-        result += std::format("{}{} = ", std::string(indent, ' '), this->name);
-        if (std::holds_alternative<std::string>(this->value)) {
-            result += "\"" + std::get<std::string>(this->value) + "\"\n";
-        } else if (std::holds_alternative<int64_t>(this->value)) {
-            result += std::to_string(std::get<int64_t>(this->value)) + "\n";
-        } else if (std::holds_alternative<Generic::float64_t>(this->value)) {
-            result += std::format("{}\n", std::get<Generic::float64_t>(this->value)); // std::format doesn't give trailing 0s
-        } else if (std::holds_alternative<bool>(this->value)) {
-            result += std::get<bool>(this->value) ? "true\n" : "false\n";
-        }
+        StringSink sink(result);
+        Serializer(sink, 0).write(*this, indent);
         return result;
     }
 }
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <TemplateRegistry.hpp>
+
+namespace PLCL::Config {
+    std::shared_ptr<const TemplateRegistry::Entry> TemplateRegistry::add(Template::TemplateRoot configTemplate) {
+        auto entry = std::make_shared<const Entry>(std::move(configTemplate));
+        std::scoped_lock lock(this->addMutex);
+        return this->publish(std::move(entry), nullptr);
+    }
+
+    std::shared_ptr<const TemplateRegistry::Entry> TemplateRegistry::load(const std::filesystem::path &path) {
+        std::filesystem::path canonical = std::filesystem::canonical(path);
+        std::shared_ptr<const Snapshot> snapshot = this->current.load(std::memory_order_acquire);
+        if (auto found = snapshot->files.find(canonical); found != snapshot->files.end()) {
+            return found->second;
+        }
+        // Parsed under the lock, so threads loading the same file at once wait for the first one instead of parsing
+        // it again.
+        std::scoped_lock lock(this->addMutex);
+        snapshot = this->current.load(std::memory_order_acquire);
+        if (auto found = snapshot->files.find(canonical); found != snapshot->files.end()) {
+            return found->second;
+        }
+        return this->publish(std::make_shared<const Entry>(Template::TemplateRoot::fromFile(canonical)), &canonical);
+    }
+
+    std::shared_ptr<const TemplateRegistry::Entry> TemplateRegistry::find(std::string_view name) const {
+        std::shared_ptr<const Snapshot> snapshot = this->current.load(std::memory_order_acquire);
+        auto found = snapshot->names.find(name);
+        return found != snapshot->names.end() ? found->second : nullptr;
+    }
+
+    std::shared_ptr<const Validator> TemplateRegistry::validator(std::string_view name) const {
+        std::shared_ptr<const Entry> entry = this->find(name);
+        if (entry == nullptr) {
+            throw std::runtime_error(std::format("No template named {} is registered", name));
+        }
+        return {entry, &entry->validator};
+    }
+
+    void TemplateRegistry::verify(const ConfigRoot &config, std::string_view name, bool strict, bool parallel) const {
+        std::vector<std::string> errors = this->validator(name)->validate(config, strict, parallel);
+        if (errors.empty()) {
+            return;
+        }
+        std::string message = std::format("Configuration {} doesn't match template {}:", config.name, name);
+        for (const auto &error : errors) {
+            message += "\n" + error;
+        }
+        throw std::runtime_error(message);
+    }
+
+    // The caller holds `addMutex`, so the snapshot can't change between the copy and the store.
+    std::shared_ptr<const TemplateRegistry::Entry> TemplateRegistry::publish(std::shared_ptr<const Entry> entry, const std::filesystem::path *path) {
+        auto snapshot = std::make_shared<Snapshot>(*this->current.load(std::memory_order_acquire));
+        if (!snapshot->names.try_emplace(std::string(entry->configTemplate.name), entry).second) {
+            throw std::runtime_error(std::format("A template named {} is already registered", entry->configTemplate.name));
+        }
+        if (path != nullptr) {
+            snapshot->files.emplace(*path, entry);
+        }
+        this->current.store(std::move(snapshot), std::memory_order_release);
+        return entry;
+    }
+}
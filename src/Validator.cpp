@@ -0,0 +1,423 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <Parallel.hpp>
+#include <Validator.hpp>
+
+namespace PLCL::Config {
+    namespace {
+        size_t words(size_t bits) {
+            return (bits + 63) / 64;
+        }
+
+        std::string_view valueTypeToString(const Generic::Value &value) {
+            if (Generic::holds_alternative<std::string_view>(value)) {
+                return "string";
+            } else if (Generic::holds_alternative<int64_t>(value)) {
+                return "int";
+            } else if (Generic::holds_alternative<Generic::float64_t>(value)) {
+                return "float";
+            }
+            return "bool";
+        }
+
+        bool matches(Template::AttributeType type, const Generic::Value &value) {
+            switch (type) {
+                case Template::AttributeType::String:
+                    return Generic::holds_alternative<std::string_view>(value);
+                case Template::AttributeType::Integer:
+                    return Generic::holds_alternative<int64_t>(value);
+                case Template::AttributeType::Float:
+                    return Generic::holds_alternative<Generic::float64_t>(value) || Generic::holds_alternative<int64_t>(value);
+                case Template::AttributeType::Boolean:
+                    return Generic::holds_alternative<bool>(value);
+                [[unlikely]] default:
+                    std::unreachable();
+            }
+        }
+
+        const Generic::Value *option(const Template::TemplateOptions *options, std::string_view name) {
+            if (options == nullptr) {
+                return nullptr;
+            }
+            for (const auto *option : options->options) {
+                if (option->name == name) {
+                    return &option->value;
+                }
+            }
+            return nullptr;
+        }
+
+        bool requiredOption(const Template::TemplateOptions *options, std::string_view owner) {
+            const auto *value = option(options, "required");
+            if (value == nullptr) {
+                return false;
+            }
+            if (auto required = Generic::get_if<bool>(value)) {
+                return *required;
+            }
+            throw std::runtime_error(std::format("Expected option required of {} to be a bool, got {}", owner, valueTypeToString(*value)));
+        }
+
+        size_t countOption(const Template::TemplateOptions *options, std::string_view name, std::string_view owner, size_t fallback) {
+            const auto *value = option(options, name);
+            if (value == nullptr) {
+                return fallback;
+            }
+            if (auto count = Generic::get_if<int64_t>(value); count && *count >= 0) {
+                return static_cast<size_t>(*count);
+            }
+            throw std::runtime_error(std::format("Expected option {} of {} to be a non-negative int", name, owner));
+        }
+
+        // Calls `onElement` and `onList` for the top-level nodes of a configuration, in the order they were written.
+        template <typename OnElement, typename OnList>
+        void forEachTopLevel(const ConfigRoot &config, OnElement &&onElement, OnList &&onList) {
+            bool ordered = config.listPositions.size() == config.lists.size();
+            size_t element = 0;
+            for (size_t i = 0; i < config.lists.size(); i++) {
+                size_t end = ordered ? std::min(config.listPositions[i], config.elements.size()) : config.elements.size();
+                for (; element < end; element++) {
+                    onElement(*config.elements[element]);
+                }
+                onList(*config.lists[i]);
+            }
+            for (; element < config.elements.size(); element++) {
+                onElement(*config.elements[element]);
+            }
+        }
+    }
+
+    class Validator::Compiler {
+    public:
+        explicit Compiler(Validator &validator) : validator(validator) {}
+
+        void root(const Template::TemplateRoot &root) {
+            for (const auto *element : root.elements) {
+                add(this->validator.root, this->validator.root.elements, "element", element->type, this->element(*element), requiredOption(element->options, element->type));
+            }
+            for (const auto *list : root.lists) {
+                add(this->validator.root, this->validator.root.lists, "list", list->type, this->list(*list), requiredOption(list->options, list->type));
+            }
+        }
+
+    private:
+        Validator &validator;
+
+        static void add(Scope &scope, Table<Entry> &table, std::string_view what, Symbol type, uint32_t index, bool required) {
+            Entry entry = {index, optional};
+            if (required) {
+                entry.bit = static_cast<uint32_t>(scope.required.size());
+                scope.required.push_back(std::format("{} {}", what, type));
+            }
+            if (!table.emplace(type, entry).second) {
+                throw std::runtime_error(std::format("Duplicate {} {} in template", what, type));
+            }
+        }
+
+        uint32_t element(const Template::TemplateElement &element) {
+            Element result;
+            for (const auto *attribute : element.attributes) {
+                auto bit = static_cast<uint32_t>(result.attributeNames.size());
+                if (!result.attributes.emplace(attribute->name, Attribute{attribute->type, bit}).second) {
+                    throw std::runtime_error(std::format("Duplicate attribute {} in template element {}", attribute->name, element.type));
+                }
+                result.attributeNames.push_back(attribute->name);
+                result.required.resize(words(result.attributeNames.size()));
+                if (attribute->required) {
+                    result.required[bit / 64] |= uint64_t{1} << (bit % 64);
+                }
+            }
+            for (const auto *list : element.lists) {
+                add(result.lists, result.lists.lists, "list", list->type, this->list(*list), requiredOption(list->options, list->type));
+            }
+            this->validator.elements.push_back(std::move(result));
+            return static_cast<uint32_t>(this->validator.elements.size() - 1);
+        }
+
+        uint32_t list(const Template::TemplateList &list) {
+            List result = {countOption(list.options, "minimumCount", list.type, 0), countOption(list.options, "maximumCount", list.type, SIZE_MAX), {}};
+            for (const auto *listElement : list.elements) {
+                if (listElement->element != nullptr) {
+                    const auto &element = *listElement->element;
+                    add(result.elements, result.elements.elements, "element", element.type, this->element(element), requiredOption(element.options, element.type));
+                }
+            }
+            this->validator.lists.push_back(std::move(result));
+            return static_cast<uint32_t>(this->validator.lists.size() - 1);
+        }
+    };
+
+    // Walks a configuration once, keeping the path to the current node for error messages. The seen bits of every
+    // open scope and element are kept on one stack, so nothing is allocated per node once it has grown.
+    class Validator::Checker {
+    public:
+        Checker(const Validator &validator, bool strict) : validator(validator), strict(strict) {}
+
+        std::vector<std::string> errors;
+        std::string path;
+        std::vector<uint64_t> bits;
+
+        void root(const ConfigRoot &config) {
+            this->path = config.name;
+            size_t mark = this->beginScope(this->validator.root);
+            forEachTopLevel(
+                config, [&](const ConfigElement &element) { this->element(this->validator.root, element, mark); },
+                [&](const ConfigList &list) { this->list(this->validator.root, list, mark); });
+            this->endScope(this->validator.root, mark);
+        }
+
+        size_t beginScope(const Scope &scope) {
+            size_t mark = this->bits.size();
+            this->bits.resize(mark + words(scope.required.size()));
+            return mark;
+        }
+
+        void endScope(const Scope &scope, size_t mark) {
+            for (size_t i = 0; i < scope.required.size(); i++) {
+                if ((this->bits[mark + i / 64] & (uint64_t{1} << (i % 64))) == 0) {
+                    this->report(std::format("Missing required {}", scope.required[i]));
+                }
+            }
+            this->bits.resize(mark);
+        }
+
+        void element(const Scope &scope, const ConfigElement &element, size_t scopeMark) {
+            size_t length = this->path.size();
+            this->path += '.';
+            this->path += element.type;
+            auto found = scope.elements.find(element.type);
+            if (found == scope.elements.end()) {
+                if (this->strict) {
+                    this->report(std::format("Unknown element {}", element.type));
+                }
+                this->path.resize(length);
+                return;
+            }
+            if (found->second.bit != optional) {
+                this->testAndSet(scopeMark, found->second.bit);
+            }
+            const Element &compiled = this->validator.elements[found->second.index];
+
+            size_t attributes = this->bits.size();
+            this->bits.resize(attributes + compiled.required.size());
+            for (const auto *attribute : element.attributes) {
+                auto expected = compiled.attributes.find(attribute->name);
+                if (expected == compiled.attributes.end()) {
+                    if (this->strict) {
+                        this->report(std::format("Unknown attribute {}", attribute->name));
+                    }
+                    continue;
+                }
+                if (this->testAndSet(attributes, expected->second.bit)) {
+                    this->report(std::format("Duplicate attribute {}", attribute->name));
+                }
+                if (!matches(expected->second.type, attribute->value)) {
+                    this->report(std::format("Type mismatch for attribute {}: expected {}, got {}", attribute->name, Template::attributeTypeToString(expected->second.type), valueTypeToString(attribute->value)));
+                }
+            }
+            this->reportMissing(attributes, compiled);
+            this->bits.resize(attributes);
+
+            size_t lists = this->beginScope(compiled.lists);
+            for (const auto *list : element.lists) {
+                this->list(compiled.lists, *list, lists);
+            }
+            this->endScope(compiled.lists, lists);
+            this->path.resize(length);
+        }
+
+        void list(const Scope &scope, const ConfigList &list, size_t scopeMark) {
+            size_t length = this->path.size();
+            this->path += '.';
+            this->path += list.type;
+            if (const List *compiled = this->listHeader(scope, list, scopeMark)) {
+                size_t elements = this->beginScope(compiled->elements);
+                this->listElements(*compiled, list, 0, list.elements.size(), elements);
+                this->endScope(compiled->elements, elements);
+            }
+            this->path.resize(length);
+        }
+
+        // Checks everything about a list but its elements, `path` must already point at the list.
+        // Returns null if the list isn't in the template.
+        const List *listHeader(const Scope &scope, const ConfigList &list, size_t scopeMark) {
+            auto found = scope.lists.find(list.type);
+            if (found == scope.lists.end()) {
+                if (this->strict) {
+                    this->report(std::format("Unknown list {}", list.type));
+                }
+                return nullptr;
+            }
+            if (found->second.bit != optional) {
+                this->testAndSet(scopeMark, found->second.bit);
+            }
+            const List &compiled = this->validator.lists[found->second.index];
+            if (list.elements.size() < compiled.minimumCount) {
+                this->report(std::format("Expected at least {} elements, got {}", compiled.minimumCount, list.elements.size()));
+            }
+            if (list.elements.size() > compiled.maximumCount) {
+                this->report(std::format("Expected at most {} elements, got {}", compiled.maximumCount, list.elements.size()));
+            }
+            return &compiled;
+        }
+
+        void listElements(const List &compiled, const ConfigList &list, size_t begin, size_t end, size_t scopeMark) {
+            for (size_t i = begin; i < end; i++) {
+                const auto *listElement = list.elements[i];
+                if (listElement->element == nullptr) {
+                    continue;
+                }
+                size_t length = this->path.size();
+                std::format_to(std::back_inserter(this->path), "[{}]", listElement->id);
+                this->element(compiled.elements, *listElement->element, scopeMark);
+                this->path.resize(length);
+            }
+        }
+
+    private:
+        const Validator &validator;
+        bool strict;
+
+        void report(std::string_view message) {
+            this->errors.push_back(std::format("{}: {}", this->path, message));
+        }
+
+        // Returns whether the bit was already set.
+        bool testAndSet(size_t mark, uint32_t bit) {
+            uint64_t &word = this->bits[mark + bit / 64];
+            uint64_t mask = uint64_t{1} << (bit % 64);
+            bool set = (word & mask) != 0;
+            word |= mask;
+            return set;
+        }
+
+        void reportMissing(size_t mark, const Element &element) {
+            for (size_t i = 0; i < element.required.size(); i++) {
+                uint64_t missing = element.required[i] & ~this->bits[mark + i];
+                while (missing != 0) {
+                    this->report(std::format("Missing required attribute {}", element.attributeNames[i * 64 + std::countr_zero(missing)]));
+                    missing &= missing - 1;
+                }
+            }
+        }
+    };
+
+    // One unit of parallel work. Tasks are created in the order the serial walk would visit their nodes, so
+    // concatenating their errors gives the same result. A large top-level list is split into a `ListHeader`, checked
+    // while planning, `ListChunk`s of its elements and a `ListFooter` that reports what none of the chunks saw.
+    struct Validator::Task {
+        enum class Kind {
+            Element,
+            List,
+            ListHeader,
+            ListChunk,
+            ListFooter
+        };
+
+        Kind kind;
+        const ConfigElement *element;
+        const ConfigList *list;
+        const List *compiled;
+        size_t begin;
+        size_t end;
+        std::vector<std::string> errors;
+        std::vector<uint64_t> bits;
+    };
+
+    Validator::Validator(const Template::TemplateRoot &configTemplate) {
+        Compiler(*this).root(configTemplate);
+    }
+
+    std::vector<std::string> Validator::validate(const ConfigRoot &config, bool strict, bool parallel) const {
+        if (parallel) {
+            return this->validateParallel(config, strict);
+        }
+        Checker checker(*this, strict);
+        checker.root(config);
+        return std::move(checker.errors);
+    }
+
+    std::vector<std::string> Validator::validateParallel(const ConfigRoot &config, bool strict) const {
+        std::vector<Task> tasks;
+        auto planList = [&](const ConfigList &list) {
+            if (list.elements.size() <= chunkSize) {
+                tasks.push_back({Task::Kind::List, nullptr, &list, nullptr, 0, 0, {}, {}});
+                return;
+            }
+            Checker header(*this, strict);
+            header.path = std::format("{}.{}", config.name, list.type);
+            header.beginScope(this->root);
+            const List *compiled = header.listHeader(this->root, list, 0);
+            tasks.push_back({Task::Kind::ListHeader, nullptr, &list, compiled, 0, 0, std::move(header.errors), std::move(header.bits)});
+            if (compiled == nullptr) {
+                return;
+            }
+            for (size_t begin = 0; begin < list.elements.size(); begin += chunkSize) {
+                tasks.push_back({Task::Kind::ListChunk, nullptr, &list, compiled, begin, std::min(begin + chunkSize, list.elements.size()), {}, {}});
+            }
+            tasks.push_back({Task::Kind::ListFooter, nullptr, &list, compiled, 0, 0, {}, {}});
+        };
+        forEachTopLevel(
+            config, [&](const ConfigElement &element) { tasks.push_back({Task::Kind::Element, &element, nullptr, nullptr, 0, 0, {}, {}}); }, planList);
+
+        Parallel::forEach(tasks.size(), [&](size_t i) {
+            Task &task = tasks[i];
+            Checker checker(*this, strict);
+            checker.path = config.name;
+            switch (task.kind) {
+                case Task::Kind::Element:
+                    checker.element(this->root, *task.element, checker.beginScope(this->root));
+                    break;
+                case Task::Kind::List:
+                    checker.list(this->root, *task.list, checker.beginScope(this->root));
+                    break;
+                case Task::Kind::ListChunk:
+                    checker.path += '.';
+                    checker.path += task.list->type;
+                    checker.listElements(*task.compiled, *task.list, task.begin, task.end, checker.beginScope(task.compiled->elements));
+                    break;
+                default:
+                    return;
+            }
+            task.errors = std::move(checker.errors);
+            task.bits = std::move(checker.bits);
+        });
+
+        // Merging the seen bits and the errors is cheap, and done in task order.
+        Checker root(*this, strict);
+        root.path = config.name;
+        root.beginScope(this->root);
+        std::vector<std::string> errors;
+        std::vector<uint64_t> listBits;
+        for (auto &task : tasks) {
+            errors.insert(errors.end(), std::make_move_iterator(task.errors.begin()), std::make_move_iterator(task.errors.end()));
+            if (task.kind == Task::Kind::ListChunk) {
+                listBits.resize(task.bits.size());
+                for (size_t i = 0; i < task.bits.size(); i++) {
+                    listBits[i] |= task.bits[i];
+                }
+            } else if (task.kind == Task::Kind::ListFooter) {
+                Checker footer(*this, strict);
+                footer.path = std::format("{}.{}", config.name, task.list->type);
+                footer.bits = std::move(listBits);
+                footer.bits.resize(words(task.compiled->elements.required.size()));
+                footer.endScope(task.compiled->elements, 0);
+                errors.insert(errors.end(), std::make_move_iterator(footer.errors.begin()), std::make_move_iterator(footer.errors.end()));
+                listBits.clear();
+            } else {
+                for (size_t i = 0; i < task.bits.size(); i++) {
+                    root.bits[i] |= task.bits[i];
+                }
+            }
+        }
+        root.endScope(this->root, 0);
+        errors.insert(errors.end(), std::make_move_iterator(root.errors.begin()), std::make_move_iterator(root.errors.end()));
+        return errors;
+    }
+}